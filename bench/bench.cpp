@@ -0,0 +1,435 @@
+// micro-benchmarks des chemins chauds du moteur (bin/Makefile : make bench)
+// ./bench [filtre] : ns/op, elements/s et allocations par op pour des entrees de taille croissante
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Camera.h"
+#include "Engine.h"
+#include "Frustum.h"
+#include "JobSystem.h"
+#include "OcclusionCulling.h"
+#include "RayQuery.h"
+
+// ---- compteur d'allocations : tous les new du programme passent par ici ----
+// (formes simples, tableaux, alignees et nothrow : chacune compte une allocation)
+
+static std::atomic<uint64_t> allocationCount{ 0 };
+
+static void* countedAlloc(size_t size) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+// malloc + marge : le pointeur d'origine est range juste avant le bloc aligne
+// (pas d'aligned_alloc : absent de MinGW)
+static void* countedAlignedAlloc(size_t size, std::align_val_t alignment) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    const size_t align = std::max(static_cast<size_t>(alignment), sizeof(void*));
+    void* raw = std::malloc(size + align + sizeof(void*));
+    if (!raw) return nullptr;
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + sizeof(void*) + align - 1) & ~static_cast<uintptr_t>(align - 1);
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+    return reinterpret_cast<void*>(aligned);
+}
+
+static void alignedFree(void* p) noexcept {
+    if (p) std::free(static_cast<void**>(p)[-1]);
+}
+
+// GCC voit free() sur un pointeur venu de operator new dans ces remplacements (c'est voulu ici)
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size) {
+    if (void* p = countedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    if (void* p = countedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, std::align_val_t alignment) {
+    if (void* p = countedAlignedAlloc(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    if (void* p = countedAlignedAlloc(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return countedAlignedAlloc(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return countedAlignedAlloc(size, alignment); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+// ---- harnais ----
+
+// empeche le compilateur de supprimer un calcul dont le resultat n'est pas utilise
+template <typename T>
+inline void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct BenchResult {
+    std::string name;
+    size_t size;
+    double nsPerOp;
+    double itemsPerSecond;
+    double allocationsPerOp;
+};
+
+class Bench {
+public:
+    double minSeconds = 0.25;   // duree minimale de mesure par cas
+    std::string filter;         // sous-chaine du nom, vide = tout
+
+    // op() traite itemsPerOp elements ; repete jusqu'a minSeconds (au moins une fois)
+    void run(const std::string& name, size_t size, size_t itemsPerOp, const std::function<void()>& op) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) return;
+        op(); // chauffe : caches, tables, pages
+
+        uint64_t iterations = 0;
+        uint64_t allocations = allocationCount.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0.0;
+        uint64_t batch = 1;
+        while (elapsed < minSeconds) {
+            for (uint64_t i = 0; i < batch; i++) op();
+            iterations += batch;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            batch *= 2;
+        }
+        allocations = allocationCount.load(std::memory_order_relaxed) - allocations;
+
+        BenchResult result;
+        result.name = name;
+        result.size = size;
+        result.nsPerOp = elapsed * 1e9 / static_cast<double>(iterations);
+        result.itemsPerSecond = static_cast<double>(itemsPerOp) * static_cast<double>(iterations) / elapsed;
+        result.allocationsPerOp = static_cast<double>(allocations) / static_cast<double>(iterations);
+        results.push_back(result);
+
+        std::printf("%-28s %10zu %16.1f %16.3e %12.2f\n", name.c_str(), size, result.nsPerOp, result.itemsPerSecond,
+                    result.allocationsPerOp);
+        std::fflush(stdout);
+    }
+
+    const std::vector<BenchResult>& all() const { return results; }
+
+private:
+    std::vector<BenchResult> results;
+};
+
+// les fonctions du moteur ecrivent leurs statistiques sur cout : coupe pendant les mesures
+class QuietCout {
+public:
+    QuietCout() : previous(std::cout.rdbuf(sink.rdbuf())) {}
+    ~QuietCout() { std::cout.rdbuf(previous); }
+
+private:
+    std::ostringstream sink;
+    std::streambuf* previous;
+};
+
+// ---- entrees generees ----
+
+// grille de (n+1)^2 sommets et 2n^2 triangles, faces v/vt/vn
+static std::string writeGridObj(size_t n) {
+    std::string path = "bench_grid_" + std::to_string(n) + ".obj";
+    std::ofstream out(path, std::ios::trunc);
+    for (size_t y = 0; y <= n; y++)
+        for (size_t x = 0; x <= n; x++)
+            out << "v " << x << " " << (x * 7 + y * 3) % 5 * 0.1f << " " << y << "\n";
+    for (size_t y = 0; y <= n; y++)
+        for (size_t x = 0; x <= n; x++)
+            out << "vt " << static_cast<float>(x) / n << " " << static_cast<float>(y) / n << "\n";
+    out << "vn 0 1 0\n";
+    for (size_t y = 0; y < n; y++) {
+        for (size_t x = 0; x < n; x++) {
+            size_t a = y * (n + 1) + x + 1, b = a + 1, c = a + n + 1, d = c + 1;
+            out << "f " << a << "/" << a << "/1 " << c << "/" << c << "/1 " << b << "/" << b << "/1\n";
+            out << "f " << b << "/" << b << "/1 " << c << "/" << c << "/1 " << d << "/" << d << "/1\n";
+        }
+    }
+    return path;
+}
+
+static void fillWorld(PhysicsWorld& world, size_t bodies, std::mt19937& rng) {
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f), height(0.0f, 50.0f);
+    world.clear();
+    world.reserve(bodies);
+    for (size_t i = 0; i < bodies; i++)
+        world.addBody(glm::vec3(position(rng), height(rng), position(rng)), glm::vec3(0.5f), 0.8f);
+}
+
+int main(int argc, char** argv) {
+    Bench bench;
+    if (argc > 1) bench.filter = argv[1];
+    std::mt19937 rng(1234);
+
+    std::printf("%-28s %10s %16s %16s %12s\n", "benchmark", "taille", "ns/op", "elements/s", "allocs/op");
+
+    // loadOBJ : fichiers de 2 a ~2M triangles
+    for (size_t n : { 1, 10, 100, 1000 }) {
+        std::string path = writeGridObj(n);
+        size_t triangles = 2 * n * n;
+        bench.run("loadOBJ", triangles, triangles, [&] {
+            QuietCout quiet;
+            MeshData mesh;
+            loadOBJ(path, mesh);
+            keep(mesh.indices.size());
+        });
+        std::remove(path.c_str());
+    }
+
+    // updatePhysics : un pas pour 1 a 1M corps (integration puis broadphase)
+    Ground ground;
+    for (size_t bodies : { 1, 100, 10000, 1000000 }) {
+        PhysicsWorld world;
+        Broadphase broadphase;
+        fillWorld(world, bodies, rng);
+        bench.run("updatePhysics", bodies, bodies, [&] {
+            updatePhysics(world, broadphase, 1.0f / 60.0f, ground);
+        });
+    }
+
+    // PhysicsWorld::step seul : integration SoA + bornes, sans broadphase
+    for (size_t bodies : { 1000, 100000, 1000000 }) {
+        PhysicsWorld world;
+        fillWorld(world, bodies, rng);
+        bench.run("PhysicsWorld::step", bodies, bodies, [&] {
+            world.step(1.0f / 60.0f);
+            keep(world.positionsY()[0]);
+        });
+    }
+
+    // Broadphase::findPairs seul (sans integration ni reponse aux contacts)
+    for (size_t bodies : { 1000, 100000, 1000000 }) {
+        PhysicsWorld world;
+        fillWorld(world, bodies, rng);
+        std::vector<BodyPair> pairs;
+        Broadphase broadphase;
+        bench.run("Broadphase::findPairs", bodies, bodies, [&] {
+            broadphase.findPairs(world, pairs);
+            keep(pairs.size());
+        });
+    }
+
+    // rayIntersectsAABB : 1 a 1M rayons contre une boite
+    for (size_t count : { 1, 1000, 1000000 }) {
+        std::vector<glm::vec3> origins(count), directions(count);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        for (size_t i = 0; i < count; i++) {
+            origins[i] = glm::vec3(unit(rng), unit(rng), unit(rng)) * 10.0f;
+            directions[i] = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.0f, 0.0f, 1e-3f));
+        }
+        const glm::vec3 boxMin(-1.0f), boxMax(1.0f);
+        bench.run("rayIntersectsAABB", count, count, [&] {
+            size_t hits = 0;
+            for (size_t i = 0; i < count; i++) hits += rayIntersectsAABB(origins[i], directions[i], boxMin, boxMax);
+            keep(hits);
+        });
+    }
+
+    // SceneRayQuery : 1 a 1M rayons contre 10k boites (BVH + paquets de 8 boites, jobs par tranches)
+    {
+        const size_t objects = 10000;
+        std::vector<glm::vec3> boundsMin(objects), boundsMax(objects);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f), size(0.1f, 2.0f), unit(-1.0f, 1.0f);
+        for (size_t i = 0; i < objects; i++) {
+            boundsMin[i] = glm::vec3(position(rng), position(rng), position(rng));
+            boundsMax[i] = boundsMin[i] + glm::vec3(size(rng), size(rng), size(rng));
+        }
+        SceneRayQuery query;
+        query.build(boundsMin, boundsMax);
+        for (size_t count : { 1, 1000, 1000000 }) {
+            std::vector<Ray> rays(count);
+            std::vector<RayResult> results(count);
+            for (size_t i = 0; i < count; i++) {
+                rays[i].origin = glm::vec3(unit(rng), unit(rng), unit(rng)) * 100.0f;
+                rays[i].direction = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.0f, 0.0f, 1e-3f));
+            }
+            bench.run("SceneRayQuery::cast", count, count, [&] {
+                query.cast(rays.data(), count, results.data());
+                keep(results[0].object);
+            });
+        }
+
+        // meme requete sur un JobSystem a 4 threads : les tranches viennent du pool de taches,
+        // cast ne doit faire aucune allocation une fois le pool chauffe
+        {
+            const size_t count = 100000;
+            JobSystem jobs(4);
+            std::vector<Ray> rays(count);
+            std::vector<RayResult> results(count);
+            for (size_t i = 0; i < count; i++) {
+                rays[i].origin = glm::vec3(unit(rng), unit(rng), unit(rng)) * 100.0f;
+                rays[i].direction = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.0f, 0.0f, 1e-3f));
+            }
+            const std::string name = "SceneRayQuery::cast/4threads";
+            bench.run(name, count, count, [&] {
+                query.cast(rays.data(), count, results.data(), jobs);
+                keep(results[0].object);
+            });
+            if (!bench.all().empty() && bench.all().back().name == name && bench.all().back().allocationsPerOp != 0.0) {
+                std::fprintf(stderr, "%s : %.2f allocations par op (0 attendu)\n", name.c_str(), bench.all().back().allocationsPerOp);
+                return 1;
+            }
+        }
+    }
+
+    // FrustumCuller::cull : 1k a 1M boites (paquets de 8 en AVX, 4 en SSE, tranches en jobs)
+    {
+        Camera camera(glm::vec3(0.0f, 2.0f, 5.0f));
+        Frustum frustum = Frustum::fromMatrix(glm::perspective(glm::radians(camera.Zoom), 800.0f / 600.0f, 0.1f, 100.0f) * camera.GetViewMatrix());
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f), size(0.1f, 2.0f);
+        for (size_t count : { 1000, 100000, 1000000 }) {
+            FrustumCuller culler;
+            culler.reserve(count);
+            for (size_t i = 0; i < count; i++) {
+                glm::vec3 boxMin(position(rng), position(rng), position(rng));
+                culler.add(boxMin, boxMin + glm::vec3(size(rng), size(rng), size(rng)));
+            }
+            bench.run("FrustumCuller::cull", count, count, [&] { keep(culler.cull(frustum).visible); });
+        }
+    }
+
+    // screenToWorld : 1 a 1M pixels
+    {
+        Camera camera(glm::vec3(0.0f, 2.0f, 5.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), 800.0f / 600.0f, 0.1f, 100.0f);
+        glm::mat4 view = camera.GetViewMatrix();
+        for (size_t count : { 1, 1000, 1000000 }) {
+            bench.run("screenToWorld", count, count, [&] {
+                glm::vec3 sum(0.0f);
+                for (size_t i = 0; i < count; i++)
+                    sum += screenToWorld(static_cast<int>(i % 800), static_cast<int>(i / 800 % 600), projection, view);
+                keep(sum);
+            });
+        }
+    }
+
+    // occlusion : rasterisation + HiZ d'une grille de murs, puis test de 1 a 100k boites derriere
+    {
+        MeshData wall;
+        wall.vertices = {
+            { glm::vec3(-0.5f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec2(0.0f) },
+            { glm::vec3( 0.5f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec2(0.0f) },
+            { glm::vec3( 0.5f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec2(0.0f) },
+            { glm::vec3(-0.5f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec2(0.0f) }
+        };
+        wall.indices = { 0, 1, 2, 0, 2, 3 };
+        MeshView wallView = wall.view();
+
+        Camera camera(glm::vec3(0.0f, 2.0f, 20.0f));
+        glm::mat4 viewProjection = glm::perspective(glm::radians(camera.Zoom), 800.0f / 600.0f, 0.1f, 100.0f) * camera.GetViewMatrix();
+        OcclusionCuller occlusion;
+        for (size_t walls : { 1, 100, 10000 }) {
+            occlusion.clearOccluders();
+            std::vector<glm::mat4> transforms;
+            size_t side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(walls))));
+            for (size_t i = 0; i < walls; i++) {
+                glm::vec3 position(static_cast<float>(i % side) - side * 0.5f, static_cast<float>(i / side % 4), -static_cast<float>(i / (side * 4)));
+                transforms.push_back(glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(1.01f)));
+            }
+            for (const glm::mat4& transform : transforms) occlusion.addOccluder(wallView, transform);
+            bench.run("OcclusionCuller::render", walls * 2, walls * 2, [&] { occlusion.render(viewProjection); });
+        }
+        for (size_t count : { 1, 1000, 100000 }) {
+            std::vector<glm::vec3> boxMin(count), boxMax(count);
+            std::vector<uint8_t> visibility(count);
+            std::uniform_real_distribution<float> x(-20.0f, 20.0f), y(0.0f, 8.0f), z(-40.0f, 10.0f);
+            for (size_t i = 0; i < count; i++) {
+                boxMin[i] = glm::vec3(x(rng), y(rng), z(rng));
+                boxMax[i] = boxMin[i] + glm::vec3(0.5f);
+            }
+            bench.run("OcclusionCuller::cull", count, count, [&] {
+                std::fill(visibility.begin(), visibility.end(), 1);
+                keep(occlusion.cull(boxMin.data(), boxMax.data(), count, visibility.data()));
+            });
+        }
+    }
+
+    // JobSystem : montee en charge de 1 a N threads (taille = nb de threads)
+    {
+        std::vector<unsigned int> threadCounts;
+        unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int n = 1; n < hardware; n *= 2) threadCounts.push_back(n);
+        threadCounts.push_back(hardware);
+
+        const size_t elements = 1 << 20;
+        std::vector<float> values(elements);
+        for (size_t i = 0; i < elements; i++) values[i] = static_cast<float>(i % 1000) * 0.01f;
+        for (unsigned int n : threadCounts) {
+            JobSystem jobs(n);
+            // parallelFor : 1M elements, calcul par element
+            bench.run("JobSystem::parallelFor", n, elements, [&] {
+                std::vector<float> partial(jobs.threadCount() * 4 + 1, 0.0f);
+                size_t grain = elements / (partial.size() - 1) + 1;
+                jobs.parallelFor(0, elements, grain, [&](size_t begin, size_t end) {
+                    float sum = 0.0f;
+                    for (size_t i = begin; i < end; i++) sum += std::sqrt(values[i]) * std::sin(values[i]);
+                    partial[begin / grain] = sum;
+                });
+                keep(partial[0]);
+            });
+            // run + wait : 10k petites taches lancees depuis un thread exterieur
+            bench.run("JobSystem::run", n, 10000, [&] {
+                JobCounter counter;
+                std::atomic<uint64_t> total{ 0 };
+                for (int i = 0; i < 10000; i++) jobs.run([&total, i] { total.fetch_add(static_cast<uint64_t>(i), std::memory_order_relaxed); }, &counter);
+                jobs.wait(counter);
+                keep(total.load());
+            });
+        }
+    }
+
+    // camera : une operation par appel
+    {
+        Camera camera(glm::vec3(0.0f, 2.0f, 5.0f));
+        bench.run("Camera::GetViewMatrix", 1, 1, [&] {
+            glm::mat4 view = camera.GetViewMatrix();
+            keep(view);
+        });
+        float offset = 1.0f;
+        bench.run("Camera::ProcessMouseMovement", 1, 1, [&] {
+            camera.ProcessMouseMovement(offset, -offset);
+            offset = -offset;
+            keep(camera.Front);
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,341 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+#include "JobSystem.h"
+#include "Mesh.h"
+
+// noeud aplati de 32 octets : deux noeuds par ligne de cache
+struct BVHNode {
+    glm::vec3 boundsMin;
+    uint32_t leftFirst;   // noeud interne : enfant gauche (le droit suit), feuille : premier triangle
+    glm::vec3 boundsMax;
+    uint32_t count;       // nb de triangles de la feuille, 0 pour un noeud interne
+
+    bool isLeaf() const { return count > 0; }
+};
+static_assert(sizeof(BVHNode) == 32, "BVHNode doit faire 32 octets");
+
+// inverse d'une direction sans infini : une composante nulle donne un tres grand nombre
+// (les produits (borne - origine) * inv restent finis, pas de NaN quand l'origine est sur un plan)
+inline glm::vec3 safeInverse(const glm::vec3& d) {
+    const float tiny = 1e-20f;
+    return glm::vec3(1.0f / (std::abs(d.x) > tiny ? d.x : std::copysign(tiny, d.x)),
+                     1.0f / (std::abs(d.y) > tiny ? d.y : std::copysign(tiny, d.y)),
+                     1.0f / (std::abs(d.z) > tiny ? d.z : std::copysign(tiny, d.z)));
+}
+
+// resultat d'un lancer de rayon
+struct BVHHit {
+    float distance = std::numeric_limits<float>::infinity();  // parametre t le long du rayon
+    uint32_t triangle = 0;                                     // indice du triangle dans le maillage
+    bool hit = false;
+};
+
+// BVH sur les triangles d'un maillage (espace modele), construite par binning SAH
+// les sous-arbres de plus de ParallelGrain triangles sont construits en parallele (jobs)
+class TriangleBVH {
+public:
+    static const int BinCount = 12;
+    static const uint32_t MaxLeafSize = 8;
+    static const uint32_t MaxDepth = 64;   // taille de la pile de parcours ; plus profond, le noeud reste une feuille
+    static const uint32_t ParallelGrain = 16384;
+
+    // construit sur la plage [indexOffset, indexOffset + indexCount) de l'index buffer (LOD 0 par defaut)
+    void build(const MeshView& mesh, size_t indexOffset = 0, size_t indexCount = 0, JobSystem& jobs = JobSystem::instance()) {
+        if (indexCount == 0) indexCount = mesh.lodCount > 0 ? mesh.lods[0].indexCount : mesh.indexCount;
+        const uint32_t triCount = static_cast<uint32_t>(indexCount / 3);
+
+        nodes.clear();
+        triangles.clear();
+        triangleIds.resize(triCount);
+        std::iota(triangleIds.begin(), triangleIds.end(), 0u);
+        if (triCount == 0) return;
+
+        // sommets de chaque triangle et centroides (temporaires)
+        std::vector<glm::vec3> verts(triCount * 3);
+        centroids.resize(triCount);
+        jobs.parallelFor(0, triCount, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++) {
+                for (int k = 0; k < 3; k++)
+                    verts[t * 3 + k] = mesh.vertices[mesh.index(indexOffset + t * 3 + k)].Position;
+                centroids[t] = (verts[t * 3] + verts[t * 3 + 1] + verts[t * 3 + 2]) * (1.0f / 3.0f);
+            }
+        }, 4096);
+        source = &verts;
+
+        // un arbre binaire a au plus 2n - 1 noeuds : taille fixe, les paires d'enfants sont
+        // reservees par un compteur atomique et chaque sous-arbre n'ecrit que ses propres noeuds
+        nodes.resize(static_cast<size_t>(triCount) * 2 - 1);
+        nodes[0].leftFirst = 0;
+        nodes[0].count = triCount;
+        updateBounds(0);
+        BuildState state(jobs);
+        buildSubtree(0, 1, state);
+        jobs.wait(state.counter);
+        nodes.resize(state.nextNode.load(std::memory_order_relaxed));
+        depth = state.deepest.load(std::memory_order_relaxed);
+
+        // triangles recopies dans l'ordre des feuilles (v0, arete 1, arete 2) pour Moller-Trumbore
+        triangles.resize(triCount * 3);
+        jobs.parallelFor(0, triCount, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const glm::vec3* v = &verts[triangleIds[i] * 3];
+                triangles[i * 3] = v[0];
+                triangles[i * 3 + 1] = v[1] - v[0];
+                triangles[i * 3 + 2] = v[2] - v[0];
+            }
+        }, 4096);
+        source = nullptr;
+        centroids.clear();
+        centroids.shrink_to_fit();
+    }
+
+    bool empty() const { return nodes.empty(); }
+    size_t nodeCount() const { return nodes.size(); }
+    size_t triangleCount() const { return triangleIds.size(); }
+    uint32_t maxDepth() const { return depth; }   // niveaux de la feuille la plus profonde
+
+    // triangle le plus proche touche par le rayon (espace modele), au-dela de tMax on ignore
+    bool intersect(const glm::vec3& origin, const glm::vec3& direction, BVHHit& hit,
+                   float tMax = std::numeric_limits<float>::infinity()) const {
+        hit = BVHHit();
+        hit.distance = tMax;
+        if (nodes.empty()) return false;
+
+        const glm::vec3 invDir = safeInverse(direction);
+        uint32_t stack[MaxDepth];   // au plus un noeud empile par niveau descendu
+        uint32_t stackSize = 0;
+        uint32_t nodeIndex = 0;
+        if (slab(nodes[0], origin, invDir, hit.distance) == Miss) return false;
+
+        for (;;) {
+            const BVHNode& node = nodes[nodeIndex];
+            if (node.isLeaf()) {
+                for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                    float t;
+                    if (intersectTriangle(i, origin, direction, hit.distance, t)) {
+                        hit.distance = t;
+                        hit.triangle = triangleIds[i];
+                        hit.hit = true;
+                    }
+                }
+                if (stackSize == 0) break;
+                nodeIndex = stack[--stackSize];
+                continue;
+            }
+
+            // enfant le plus proche d'abord, l'autre sur la pile
+            uint32_t near = node.leftFirst, far = node.leftFirst + 1;
+            float dNear = slab(nodes[near], origin, invDir, hit.distance);
+            float dFar = slab(nodes[far], origin, invDir, hit.distance);
+            if (dNear > dFar) { std::swap(dNear, dFar); std::swap(near, far); }
+
+            if (dNear == Miss) {
+                if (stackSize == 0) break;
+                nodeIndex = stack[--stackSize];
+            } else {
+                nodeIndex = near;
+                if (dFar != Miss) {
+                    assert(stackSize < MaxDepth);
+                    stack[stackSize++] = far;
+                }
+            }
+        }
+        return hit.hit;
+    }
+
+private:
+    std::vector<BVHNode> nodes;
+    std::vector<glm::vec3> triangles;     // 3 vec3 par triangle, ordre des feuilles
+    std::vector<uint32_t> triangleIds;    // ordre des feuilles -> triangle du maillage
+    uint32_t depth = 0;
+
+    // uniquement pendant build()
+    std::vector<glm::vec3> centroids;
+    const std::vector<glm::vec3>* source = nullptr;
+
+    // partage par les taches d'une construction
+    struct BuildState {
+        explicit BuildState(JobSystem& system) : jobs(system) {}
+        JobSystem& jobs;
+        JobCounter counter;                    // sous-arbres en cours
+        std::atomic<uint32_t> nextNode{ 1 };   // premier noeud libre de nodes
+        std::atomic<uint32_t> deepest{ 1 };
+    };
+
+    static constexpr float Miss = std::numeric_limits<float>::infinity();
+
+    struct Bin {
+        glm::vec3 boundsMin = glm::vec3(std::numeric_limits<float>::max());
+        glm::vec3 boundsMax = glm::vec3(-std::numeric_limits<float>::max());
+        uint32_t count = 0;
+    };
+
+    static float area(const glm::vec3& mn, const glm::vec3& mx) {
+        glm::vec3 e = mx - mn;
+        return e.x * e.y + e.y * e.z + e.z * e.x;
+    }
+
+    // decoupe le sous-arbre de root ; les enfants assez gros partent dans une tache (comptee dans state.counter)
+    // (noeud, profondeur) : un maillage degenere ne peut pas depasser MaxDepth niveaux
+    void buildSubtree(uint32_t root, uint32_t rootDepth, BuildState& state) {
+        std::vector<std::pair<uint32_t, uint32_t>> stack;
+        stack.push_back({ root, rootDepth });
+        uint32_t localDepth = rootDepth;
+        while (!stack.empty()) {
+            uint32_t nodeIndex = stack.back().first, nodeDepth = stack.back().second;
+            stack.pop_back();
+            localDepth = std::max(localDepth, nodeDepth);
+            if (nodeDepth >= MaxDepth || !subdivide(nodeIndex, state)) continue;
+            for (uint32_t child = nodes[nodeIndex].leftFirst; child < nodes[nodeIndex].leftFirst + 2; child++) {
+                if (nodes[child].count >= ParallelGrain)
+                    state.jobs.run([this, child, nodeDepth, &state]() { buildSubtree(child, nodeDepth + 1, state); }, &state.counter);
+                else
+                    stack.push_back({ child, nodeDepth + 1 });
+            }
+        }
+        uint32_t seen = state.deepest.load(std::memory_order_relaxed);
+        while (seen < localDepth && !state.deepest.compare_exchange_weak(seen, localDepth, std::memory_order_relaxed)) {}
+    }
+
+    void updateBounds(uint32_t nodeIndex) {
+        BVHNode& node = nodes[nodeIndex];
+        node.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+        node.boundsMax = glm::vec3(-std::numeric_limits<float>::max());
+        for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+            const glm::vec3* v = &(*source)[triangleIds[i] * 3];
+            for (int k = 0; k < 3; k++) {
+                node.boundsMin = glm::min(node.boundsMin, v[k]);
+                node.boundsMax = glm::max(node.boundsMax, v[k]);
+            }
+        }
+    }
+
+    // coupe le noeud si le SAH le justifie ; renvoie vrai si deux enfants ont ete crees
+    bool subdivide(uint32_t nodeIndex, BuildState& state) {
+        BVHNode node = nodes[nodeIndex];
+        if (node.count <= 2) return false;
+
+        glm::vec3 cMin(std::numeric_limits<float>::max()), cMax(-std::numeric_limits<float>::max());
+        for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+            cMin = glm::min(cMin, centroids[triangleIds[i]]);
+            cMax = glm::max(cMax, centroids[triangleIds[i]]);
+        }
+
+        int bestAxis = -1;
+        int bestSplit = 0;
+        float bestCost = std::numeric_limits<float>::max();
+        for (int axis = 0; axis < 3; axis++) {
+            float extent = cMax[axis] - cMin[axis];
+            if (extent <= 0.0f) continue;
+            float scale = BinCount / extent;
+
+            Bin bins[BinCount];
+            for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                uint32_t t = triangleIds[i];
+                int b = std::min(BinCount - 1, static_cast<int>((centroids[t][axis] - cMin[axis]) * scale));
+                const glm::vec3* v = &(*source)[t * 3];
+                for (int k = 0; k < 3; k++) {
+                    bins[b].boundsMin = glm::min(bins[b].boundsMin, v[k]);
+                    bins[b].boundsMax = glm::max(bins[b].boundsMax, v[k]);
+                }
+                bins[b].count++;
+            }
+
+            // balayage gauche -> droite puis droite -> gauche des aires et effectifs cumules
+            float leftArea[BinCount - 1], rightArea[BinCount - 1];
+            uint32_t leftCount[BinCount - 1], rightCount[BinCount - 1];
+            Bin left, right;
+            for (int i = 0; i < BinCount - 1; i++) {
+                left.count += bins[i].count;
+                left.boundsMin = glm::min(left.boundsMin, bins[i].boundsMin);
+                left.boundsMax = glm::max(left.boundsMax, bins[i].boundsMax);
+                leftCount[i] = left.count;
+                leftArea[i] = left.count ? area(left.boundsMin, left.boundsMax) : 0.0f;
+
+                int j = BinCount - 1 - i;
+                right.count += bins[j].count;
+                right.boundsMin = glm::min(right.boundsMin, bins[j].boundsMin);
+                right.boundsMax = glm::max(right.boundsMax, bins[j].boundsMax);
+                rightCount[j - 1] = right.count;
+                rightArea[j - 1] = right.count ? area(right.boundsMin, right.boundsMax) : 0.0f;
+            }
+            for (int i = 0; i < BinCount - 1; i++) {
+                float cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+                if (leftCount[i] && rightCount[i] && cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = i;
+                }
+            }
+        }
+
+        // cout d'une feuille : tester tous ses triangles
+        float leafCost = node.count * area(node.boundsMin, node.boundsMax);
+        if (bestAxis < 0 || (bestCost >= leafCost && node.count <= MaxLeafSize)) return false;
+
+        // partition en place selon le bin
+        float scale = BinCount / (cMax[bestAxis] - cMin[bestAxis]);
+        uint32_t i = node.leftFirst, end = node.leftFirst + node.count;
+        while (i < end) {
+            int b = std::min(BinCount - 1, static_cast<int>((centroids[triangleIds[i]][bestAxis] - cMin[bestAxis]) * scale));
+            if (b <= bestSplit) i++;
+            else std::swap(triangleIds[i], triangleIds[--end]);
+        }
+        uint32_t leftCountFinal = i - node.leftFirst;
+        if (leftCountFinal == 0 || leftCountFinal == node.count) return false;
+
+        uint32_t leftIndex = state.nextNode.fetch_add(2, std::memory_order_relaxed);
+        nodes[leftIndex].leftFirst = node.leftFirst;
+        nodes[leftIndex].count = leftCountFinal;
+        nodes[leftIndex + 1].leftFirst = i;
+        nodes[leftIndex + 1].count = node.count - leftCountFinal;
+        updateBounds(leftIndex);
+        updateBounds(leftIndex + 1);
+
+        nodes[nodeIndex].leftFirst = leftIndex;
+        nodes[nodeIndex].count = 0;
+        return true;
+    }
+
+    // distance d'entree dans la boite, Miss si pas touchee avant tMax
+    static float slab(const BVHNode& node, const glm::vec3& origin, const glm::vec3& invDir, float tMax) {
+        glm::vec3 t0 = (node.boundsMin - origin) * invDir;
+        glm::vec3 t1 = (node.boundsMax - origin) * invDir;
+        glm::vec3 tNear = glm::min(t0, t1), tFar = glm::max(t0, t1);
+        float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+        float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, tMax));
+        return enter <= exit ? enter : Miss;
+    }
+
+    // Moller-Trumbore (deux faces)
+    bool intersectTriangle(uint32_t i, const glm::vec3& origin, const glm::vec3& direction, float tMax, float& t) const {
+        const glm::vec3& v0 = triangles[i * 3];
+        const glm::vec3& e1 = triangles[i * 3 + 1];
+        const glm::vec3& e2 = triangles[i * 3 + 2];
+        glm::vec3 p = glm::cross(direction, e2);
+        float det = glm::dot(e1, p);
+        if (std::abs(det) < 1e-12f) return false;
+        float invDet = 1.0f / det;
+        glm::vec3 s = origin - v0;
+        float u = glm::dot(s, p) * invDet;
+        if (u < 0.0f || u > 1.0f) return false;
+        glm::vec3 q = glm::cross(s, e1);
+        float v = glm::dot(direction, q) * invDet;
+        if (v < 0.0f || u + v > 1.0f) return false;
+        t = glm::dot(e2, q) * invDet;
+        return t > 0.0f && t < tMax;
+    }
+};
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "PhysicsWorld.h"
+
+// compteurs de la derniere passe (pour regler la taille des cellules)
+struct BroadphaseStats {
+    size_t bodies = 0;
+    size_t candidatePairs = 0;   // paires sorties de la broadphase
+    size_t contacts = 0;         // paires reellement en contact (narrowphase)
+    size_t occupiedCells = 0;    // seaux de la grille non vides
+    size_t largeBodies = 0;      // corps sur plus de MaxCellsPerBody cellules (testes contre tous)
+    double broadphaseMs = 0.0;
+    double narrowphaseMs = 0.0;
+};
+
+// recherche des paires de boites qui se chevauchent sans tester toutes les paires
+// (grille uniforme hachee : lineaire en nombre de corps, dense ou clairseme)
+class Broadphase {
+public:
+    float cellSize = 1.0f;   // arete d'une cellule de la grille (~ taille des corps)
+
+    // au-dela, un corps n'est pas insere dans la grille (un corps de 1000x1000 cellules
+    // y ajouterait un million d'entrees) : il est teste contre tous les autres
+    static const uint64_t MaxCellsPerBody = 64;
+
+    // remplit pairs (a < b, sans doublon) avec les boites qui se chevauchent
+    void findPairs(const PhysicsWorld& world, std::vector<BodyPair>& pairs) {
+        auto start = std::chrono::high_resolution_clock::now();
+        pairs.clear();
+        lastStats = BroadphaseStats();
+        lastStats.bodies = world.size();
+
+        hashGridPairs(world, pairs);
+
+        lastStats.candidatePairs = pairs.size();
+        lastStats.broadphaseMs = elapsedMs(start);
+    }
+
+    // broadphase + reponse aux collisions ; renvoie le nombre de contacts
+    size_t collide(PhysicsWorld& world) {
+        findPairs(world, pairs);
+        auto start = std::chrono::high_resolution_clock::now();
+        lastStats.contacts = world.resolveContacts(pairs);
+        lastStats.narrowphaseMs = elapsedMs(start);
+        return lastStats.contacts;
+    }
+
+    const BroadphaseStats& stats() const { return lastStats; }
+
+private:
+    BroadphaseStats lastStats;
+    std::vector<BodyPair> pairs;
+
+    // grille : une entree (cellule, corps) par cellule couverte par la boite,
+    // rangee par seau de hachage (tri par comptage, lineaire)
+    struct CellEntry {
+        uint64_t cell;
+        BodyId body;
+    };
+    std::vector<CellEntry> entries, sorted;
+    std::vector<size_t> bucketStart, bucketCursor;
+    std::vector<BodyId> large;   // corps hors grille
+
+    static double elapsedMs(std::chrono::high_resolution_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    static bool overlaps(const PhysicsWorld& w, BodyId a, BodyId b) {
+        return w.boundsMinX()[a] <= w.boundsMaxX()[b] && w.boundsMinX()[b] <= w.boundsMaxX()[a]
+            && w.boundsMinY()[a] <= w.boundsMaxY()[b] && w.boundsMinY()[b] <= w.boundsMaxY()[a]
+            && w.boundsMinZ()[a] <= w.boundsMaxZ()[b] && w.boundsMinZ()[b] <= w.boundsMaxZ()[a];
+    }
+
+    // coordonnee de cellule bornee a la plage de cellKey (une conversion float -> int hors plage est indefinie)
+    static const int CellLimit = 1 << 20;
+
+    static int cellCoord(float value, float inv) {
+        float cell = std::floor(value * inv);
+        if (cell < static_cast<float>(-CellLimit)) return -CellLimit;
+        if (cell > static_cast<float>(CellLimit - 1)) return CellLimit - 1;
+        return static_cast<int>(cell);
+    }
+
+    static uint64_t cellKey(int x, int y, int z) {
+        // 21 bits par axe (coordonnees signees decalees)
+        const uint64_t mask = (1ull << 21) - 1;
+        return ((static_cast<uint64_t>(x + (1 << 20)) & mask) << 42)
+             | ((static_cast<uint64_t>(y + (1 << 20)) & mask) << 21)
+             | (static_cast<uint64_t>(z + (1 << 20)) & mask);
+    }
+
+    static size_t bucketOf(uint64_t cell, size_t mask) {
+        cell *= 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(cell ^ (cell >> 32)) & mask;
+    }
+
+    void hashGridPairs(const PhysicsWorld& w, std::vector<BodyPair>& out) {
+        const size_t count = w.size();
+        const float inv = 1.0f / cellSize;
+        entries.clear();
+        large.clear();
+
+        for (size_t i = 0; i < count; i++) {
+            const float minX = w.boundsMinX()[i], minY = w.boundsMinY()[i], minZ = w.boundsMinZ()[i];
+            const float maxX = w.boundsMaxX()[i], maxY = w.boundsMaxY()[i], maxZ = w.boundsMaxZ()[i];
+            // boite NaN : aucune comparaison ne la fait chevaucher quoi que ce soit
+            if (std::isnan(minX) || std::isnan(minY) || std::isnan(minZ) || std::isnan(maxX) || std::isnan(maxY) || std::isnan(maxZ)) continue;
+            int x0 = cellCoord(minX, inv), x1 = cellCoord(maxX, inv);
+            int y0 = cellCoord(minY, inv), y1 = cellCoord(maxY, inv);
+            int z0 = cellCoord(minZ, inv), z1 = cellCoord(maxZ, inv);
+            if (x1 < x0 || y1 < y0 || z1 < z0) continue;   // boite inversee
+            uint64_t cells = static_cast<uint64_t>(x1 - x0 + 1) * static_cast<uint64_t>(y1 - y0 + 1) * static_cast<uint64_t>(z1 - z0 + 1);
+            if (cells > MaxCellsPerBody) {
+                large.push_back(static_cast<BodyId>(i));
+                continue;
+            }
+            for (int x = x0; x <= x1; x++)
+                for (int y = y0; y <= y1; y++)
+                    for (int z = z0; z <= z1; z++)
+                        entries.push_back({ cellKey(x, y, z), static_cast<BodyId>(i) });
+        }
+        lastStats.largeBodies = large.size();
+
+        // table de 2x le nombre d'entrees (puissance de 2)
+        size_t buckets = 1;
+        while (buckets < entries.size() * 2) buckets <<= 1;
+        const size_t mask = buckets - 1;
+        bucketStart.assign(buckets + 1, 0);
+        for (const CellEntry& e : entries) bucketStart[bucketOf(e.cell, mask) + 1]++;
+        for (size_t b = 0; b < buckets; b++) bucketStart[b + 1] += bucketStart[b];
+        sorted.resize(entries.size());
+        {
+            std::vector<size_t>& cursor = bucketCursor;
+            cursor.assign(bucketStart.begin(), bucketStart.end() - 1);
+            for (const CellEntry& e : entries) sorted[cursor[bucketOf(e.cell, mask)]++] = e;
+        }
+
+        for (size_t b = 0; b < buckets; b++) {
+            const size_t begin = bucketStart[b], end = bucketStart[b + 1];
+            if (begin == end) continue;
+            lastStats.occupiedCells++;
+
+            for (size_t i = begin; i < end; i++) {
+                for (size_t j = i + 1; j < end; j++) {
+                    // deux cellules differentes peuvent tomber dans le meme seau
+                    if (sorted[i].cell != sorted[j].cell) continue;
+                    BodyId a = std::min(sorted[i].body, sorted[j].body), c = std::max(sorted[i].body, sorted[j].body);
+                    if (!overlaps(w, a, c)) continue;
+                    // une paire partage souvent plusieurs cellules : on ne la garde que dans
+                    // la cellule qui contient le coin min de l'intersection
+                    int cx = cellCoord(std::max(w.boundsMinX()[a], w.boundsMinX()[c]), inv);
+                    int cy = cellCoord(std::max(w.boundsMinY()[a], w.boundsMinY()[c]), inv);
+                    int cz = cellCoord(std::max(w.boundsMinZ()[a], w.boundsMinZ()[c]), inv);
+                    if (cellKey(cx, cy, cz) == sorted[i].cell) out.push_back({ a, c });
+                }
+            }
+        }
+
+        // corps hors grille contre tous les autres (une seule fois par paire entre deux gros corps)
+        for (size_t k = 0; k < large.size(); k++) {
+            const BodyId body = large[k];
+            for (size_t i = 0; i < count; i++) {
+                const BodyId other = static_cast<BodyId>(i);
+                if (other == body || !overlaps(w, body, other)) continue;
+                if (isLarge(other) && other < body) continue;   // deja sortie depuis other
+                out.push_back({ std::min(body, other), std::max(body, other) });
+            }
+        }
+    }
+
+    // large est range par indice croissant
+    bool isLarge(BodyId body) const {
+        return std::binary_search(large.begin(), large.end(), body);
+    }
+};
+
+#endif
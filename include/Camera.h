@@ -5,6 +5,7 @@
 #include <glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include "Frustum.h"
 
 class Camera {
 public:
@@ -43,6 +44,11 @@ public:
         return glm::lookAt(Position, Position + Front, Up);
     }
 
+    // plans du frustum pour la projection donnee (dans l'espace monde)
+    Frustum GetFrustum(const glm::mat4& projection) const {
+        return Frustum::fromMatrix(projection * GetViewMatrix());
+    }
+
     // mouv clavier
     void ProcessKeyboard(int direction, float deltaTime) {
         float velocity = MovementSpeed * deltaTime;
@@ -75,6 +81,14 @@ public:
         updateCameraVectors();
     }
 
+    // place la camera (chemins de camera scriptes)
+    void SetPose(const glm::vec3& position, float yaw, float pitch) {
+        Position = position;
+        Yaw = yaw;
+        Pitch = pitch;
+        updateCameraVectors();
+    }
+
     // traite le zoom 
     void ProcessMouseScroll(float yoffset) {
         Zoom -= yoffset;
@@ -0,0 +1,72 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <memory>
+#include <string>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Broadphase.h"
+#include "Mesh.h"
+#include "PhysicsWorld.h"
+
+// fonctions du moteur partagees par l'executable fenetre et les benchmarks (src/engine.cpp)
+
+// struct pour le sol (plan), dessine comme un modele du registre
+struct Ground {
+    glm::vec3 position;
+    glm::vec3 scale;
+    
+    Ground() : position(0.0f, -2.0f, 0.0f), scale(20.0f, 1.0f, 20.0f) {}
+
+    // maillage du plan unitaire, range dans l'arene avec les autres modeles
+    std::unique_ptr<MeshAsset> makeAsset() const {
+        std::unique_ptr<MeshAsset> asset(new MeshAsset());
+        asset->data.vertices = {
+            // positions                      // normales               // coord de texture
+            { glm::vec3(-0.5f, 0.0f, -0.5f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec2(0.0f,  0.0f) },
+            { glm::vec3( 0.5f, 0.0f, -0.5f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec2(20.0f, 0.0f) },
+            { glm::vec3( 0.5f, 0.0f,  0.5f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec2(20.0f, 20.0f) },
+            { glm::vec3(-0.5f, 0.0f,  0.5f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec2(0.0f,  20.0f) }
+        };
+        asset->data.indices = {
+            0, 1, 2,
+            0, 2, 3
+        };
+        // 16 bits comme les petits modeles : meme arene, pas d'appel de dessin en plus
+        asset->data.indices16.assign(asset->data.indices.begin(), asset->data.indices.end());
+        asset->data.indexType = GL_UNSIGNED_SHORT;
+        asset->view = asset->data.view();
+        return asset;
+    }
+
+    glm::mat4 transform() const {
+        return glm::scale(glm::translate(glm::mat4(1.0f), position), scale);
+    }
+};
+
+// MAJ la physique de tous les corps (le sol est un plan a la hauteur de ground)
+// puis collisions entre corps via la broadphase
+void updatePhysics(PhysicsWorld& world, Broadphase& broadphase, float deltaTime, const Ground& ground);
+
+// lit un .obj et soude les sommets identiques
+bool loadOBJ(const std::string& path, MeshData& out);
+
+// passe d'optimisation optionnelle entre le chargement et l'envoi au GPU
+extern bool optimizeMeshes;
+
+// chaine de LODs a la suite du LOD 0 dans le meme tableau d'indices
+void buildLods(MeshData& mesh);
+void optimizeLoadedMesh(MeshData& mesh);
+
+// optimisation du LOD 0, chaine de LODs puis ordre des sommets
+void processLoadedMesh(MeshData& mesh);
+
+// cache binaire projete en memoire s'il est a jour, sinon .obj puis ecriture du cache
+bool loadModel(const std::string& path, MeshAsset& asset);
+
+bool rayIntersectsAABB(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, const glm::vec3& boxMin, const glm::vec3& boxMax);
+
+// direction du rayon (espace monde) sous le pixel (mouseX, mouseY) d'une vue 800x600
+glm::vec3 screenToWorld(int mouseX, int mouseY, const glm::mat4& projection, const glm::mat4& view);
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "JobSystem.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// 6 plans (normale vers l'interieur) : gauche, droite, bas, haut, proche, loin
+struct Frustum {
+    glm::vec4 planes[6];
+
+    // extraction depuis projection * vue (methode de Gribb & Hartmann)
+    static Frustum fromMatrix(const glm::mat4& m) {
+        Frustum f;
+        glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+        f.planes[0] = row3 + row0;
+        f.planes[1] = row3 - row0;
+        f.planes[2] = row3 + row1;
+        f.planes[3] = row3 - row1;
+        f.planes[4] = row3 + row2;
+        f.planes[5] = row3 - row2;
+
+        for (glm::vec4& p : f.planes) {
+            float len = glm::length(glm::vec3(p));
+            if (len > 0.0f) p /= len;
+        }
+        return f;
+    }
+
+    // test scalaire d'une boite (sommet le plus en avant de chaque plan)
+    bool intersects(const glm::vec3& boxMin, const glm::vec3& boxMax) const {
+        for (const glm::vec4& p : planes) {
+            glm::vec3 v(p.x > 0.0f ? boxMax.x : boxMin.x,
+                        p.y > 0.0f ? boxMax.y : boxMin.y,
+                        p.z > 0.0f ? boxMax.z : boxMin.z);
+            if (p.x * v.x + p.y * v.y + p.z * v.z + p.w < 0.0f) return false;
+        }
+        return true;
+    }
+};
+
+// compteurs de la derniere passe de culling
+struct CullStats {
+    size_t visible = 0;
+    size_t culled = 0;
+};
+
+// boites englobantes en structure de tableaux, testees par paquets de 8 (AVX) ou 4 (SSE)
+// independant d'OpenGL : utilisable dans un test ou un benchmark sans contexte
+class FrustumCuller {
+public:
+    void clear() {
+        for (auto* array : { &minX, &minY, &minZ, &maxX, &maxY, &maxZ }) array->clear();
+        visibility.clear();
+    }
+
+    void reserve(size_t count) {
+        for (auto* array : { &minX, &minY, &minZ, &maxX, &maxY, &maxZ }) array->reserve(count);
+        visibility.reserve(count);
+    }
+
+    // renvoie l'indice de la boite (a relire dans visible())
+    size_t add(const glm::vec3& boxMin, const glm::vec3& boxMax) {
+        minX.push_back(boxMin.x); minY.push_back(boxMin.y); minZ.push_back(boxMin.z);
+        maxX.push_back(boxMax.x); maxY.push_back(boxMax.y); maxZ.push_back(boxMax.z);
+        return minX.size() - 1;
+    }
+
+    size_t size() const { return minX.size(); }
+
+    bool visible(size_t index) const { return visibility[index] != 0; }
+
+    static const size_t CullGrain = 4096;   // boites par tache (multiple de 8)
+
+    CullStats cull(const Frustum& frustum, JobSystem& jobs = JobSystem::instance()) {
+        const size_t count = size();
+        visibility.assign(count, 1);
+        jobs.parallelFor(0, count, CullGrain, [&](size_t begin, size_t end) { cullRange(frustum, begin, end); });
+
+        CullStats stats;
+        for (size_t k = 0; k < count; k++) stats.visible += visibility[k];
+        stats.culled = count - stats.visible;
+        lastStats = stats;
+        return stats;
+    }
+
+    const CullStats& stats() const { return lastStats; }
+
+private:
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+    std::vector<uint8_t> visibility;
+    CullStats lastStats;
+
+    // tous les plans sur la tranche [begin, end) : 8 (AVX) ou 4 (SSE) boites par iteration
+    void cullRange(const Frustum& frustum, size_t begin, size_t end) {
+        for (const glm::vec4& plane : frustum.planes) {
+            // meme plan pour tout le paquet : le sommet "positif" se choisit une fois par axe
+            const float* px = plane.x > 0.0f ? maxX.data() : minX.data();
+            const float* py = plane.y > 0.0f ? maxY.data() : minY.data();
+            const float* pz = plane.z > 0.0f ? maxZ.data() : minZ.data();
+            size_t i = begin;
+#if defined(__AVX__)
+            const __m256 nx8 = _mm256_set1_ps(plane.x), ny8 = _mm256_set1_ps(plane.y);
+            const __m256 nz8 = _mm256_set1_ps(plane.z), d8 = _mm256_set1_ps(plane.w);
+            const __m256 zero8 = _mm256_setzero_ps();
+            for (; i + 8 <= end; i += 8) {
+                __m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx8, _mm256_loadu_ps(px + i)),
+                                                          _mm256_mul_ps(ny8, _mm256_loadu_ps(py + i))),
+                                            _mm256_add_ps(_mm256_mul_ps(nz8, _mm256_loadu_ps(pz + i)), d8));
+                int outside = _mm256_movemask_ps(_mm256_cmp_ps(dist, zero8, _CMP_LT_OQ));
+                if (outside) markOutside(i, outside, 8);
+            }
+#endif
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+            const __m128 nx4 = _mm_set1_ps(plane.x), ny4 = _mm_set1_ps(plane.y);
+            const __m128 nz4 = _mm_set1_ps(plane.z), d4 = _mm_set1_ps(plane.w);
+            const __m128 zero4 = _mm_setzero_ps();
+            for (; i + 4 <= end; i += 4) {
+                __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx4, _mm_loadu_ps(px + i)),
+                                                    _mm_mul_ps(ny4, _mm_loadu_ps(py + i))),
+                                         _mm_add_ps(_mm_mul_ps(nz4, _mm_loadu_ps(pz + i)), d4));
+                int outside = _mm_movemask_ps(_mm_cmplt_ps(dist, zero4));
+                if (outside) markOutside(i, outside, 4);
+            }
+#endif
+            for (; i < end; i++) {
+                if (plane.x * px[i] + plane.y * py[i] + plane.z * pz[i] + plane.w < 0.0f) visibility[i] = 0;
+            }
+        }
+    }
+
+    void markOutside(size_t base, int mask, int lanes) {
+        for (int lane = 0; lane < lanes; lane++)
+            if (mask & (1 << lane)) visibility[base + lane] = 0;
+    }
+};
+
+#endif
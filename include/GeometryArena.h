@@ -0,0 +1,282 @@
+#ifndef GEOMETRY_ARENA_H
+#define GEOMETRY_ARENA_H
+
+#include <glad.h>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "InstanceData.h"
+#include "Mesh.h"
+
+// plage d'un maillage dans l'arene
+struct ArenaRange {
+    uint32_t baseVertex = 0;
+    uint32_t firstIndex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+};
+
+// disposition imposee par glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;
+};
+
+struct GeometryArenaStats {
+    size_t commands = 0;     // commandes envoyees (apres compaction)
+    size_t instances = 0;
+    size_t uploadBytes = 0;  // instances et commandes envoyees cette frame
+    bool multiDraw = false;  // un seul glMultiDrawElementsIndirect
+};
+
+// un VBO et un EBO partages par tous les maillages d'un meme format de sommet :
+// un seul VAO, et chaque frame une liste de commandes indirectes envoyee en un appel
+// (glMultiDrawElementsIndirect, GL 4.3 ou ARB_multi_draw_indirect + ARB_base_instance)
+// sans ce support : une boucle de glDrawElementsInstancedBaseVertex sur le meme VAO
+// un seul type d'indice par appel : une arene par type, les maillages 16 bits ne sont pas elargis
+// (baseVertex decale les indices, donc chaque maillage doit seulement tenir en 65536 sommets)
+class GeometryArena {
+public:
+    GeometryArena(VertexLayout layout, GLenum indexType) : layout(layout), indexType(indexType) {}
+    ~GeometryArena() { release(); }
+
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    // a appeler une fois le contexte GL cree ; les capacites doublent au besoin
+    void init(size_t vertexCapacity = 1 << 16, size_t indexCapacity = 1 << 18) {
+        glGenVertexArrays(1, &vertexArray);
+        glGenBuffers(1, &vertexBuffer);
+        glGenBuffers(1, &indexBuffer);
+        glGenBuffers(1, &instanceBuffer);
+
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, vertexCapacity * vertexSize(), nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCapacity * indexSize(), nullptr, GL_STATIC_DRAW);
+        vertexCapacityCount = vertexCapacity;
+        indexCapacityCount = indexCapacity;
+        setupVertexArray();
+
+        multiDraw = multiDrawSupported();
+#if defined(GL_VERSION_4_3) || defined(GL_ARB_multi_draw_indirect)
+        if (multiDraw) glGenBuffers(1, &indirectBuffer);
+#endif
+        std::cout << "Arene " << (layout == VertexLayout::Packed ? "compressee" : "float") << " "
+                  << (indexType == GL_UNSIGNED_SHORT ? "16" : "32") << " bits : "
+                  << (multiDraw ? "glMultiDrawElementsIndirect" : "boucle glDrawElementsInstancedBaseVertex") << std::endl;
+    }
+
+    bool initialized() const { return vertexArray != 0; }
+
+    // copie les sommets (deja au format de l'arene) et les indices du maillage a la suite
+    // indices 16 bits dans une arene 32 bits : elargis ; l'inverse n'est pas possible
+    ArenaRange allocate(const void* vertices, size_t vertexCount, const MeshView& mesh) {
+        assert(mesh.indexType == indexType || indexType == GL_UNSIGNED_INT);
+        reserve(vertexUsed + vertexCount, indexUsed + mesh.indexCount);
+
+        ArenaRange range;
+        range.baseVertex = static_cast<uint32_t>(vertexUsed);
+        range.firstIndex = static_cast<uint32_t>(indexUsed);
+        range.vertexCount = static_cast<uint32_t>(vertexCount);
+        range.indexCount = static_cast<uint32_t>(mesh.indexCount);
+
+        const void* indices = mesh.indices;
+        std::vector<uint32_t> widened;
+        if (mesh.indexType != indexType) {
+            widened.resize(mesh.indexCount);
+            for (size_t i = 0; i < mesh.indexCount; i++) widened[i] = mesh.index(i);
+            indices = widened.data();
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glBufferSubData(GL_ARRAY_BUFFER, vertexUsed * vertexSize(), vertexCount * vertexSize(), vertices);
+        glBindVertexArray(0); // l'EBO se lie au VAO courant
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexUsed * indexSize(), mesh.indexCount * indexSize(), indices);
+
+        vertexUsed += vertexCount;
+        indexUsed += mesh.indexCount;
+        return range;
+    }
+
+    // ---- commandes de la frame ----
+
+    void clearDraws() {
+        commands.clear();
+        instances.clear();
+    }
+
+    // une commande par (maillage, LOD) ; les groupes sans instance visible sont ecartes
+    void addDraw(uint32_t firstIndex, uint32_t indexCount, uint32_t baseVertex, const InstanceData* data, size_t count) {
+        if (count == 0 || indexCount == 0) return;
+        DrawElementsIndirectCommand command;
+        command.count = indexCount;
+        command.instanceCount = static_cast<uint32_t>(count);
+        command.firstIndex = firstIndex;
+        command.baseVertex = static_cast<int32_t>(baseVertex);
+        command.baseInstance = static_cast<uint32_t>(instances.size());
+        commands.push_back(command);
+        instances.insert(instances.end(), data, data + count);
+    }
+
+    size_t drawCount() const { return commands.size(); }
+
+    // envoie les instances et les commandes puis dessine tout (VAO de l'arene deja lie)
+    void draw() {
+        stats = GeometryArenaStats();
+        if (commands.empty()) return;
+
+        // orphelinage : nouveau stockage sans attendre les draws de la frame precedente
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        instanceCapacity = std::max(instanceCapacity, instances.size());
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(InstanceData), instances.data());
+
+        stats.commands = commands.size();
+        stats.instances = instances.size();
+        stats.uploadBytes = instances.size() * sizeof(InstanceData);
+        stats.multiDraw = multiDraw;
+
+#if defined(GL_VERSION_4_3) || defined(GL_ARB_multi_draw_indirect)
+        if (multiDraw) {
+            bindInstanceAttributes(instanceBuffer, 0); // baseInstance decale les attributs d'instance
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_STREAM_DRAW);
+            stats.uploadBytes += commands.size() * sizeof(DrawElementsIndirectCommand);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, indexType, nullptr, static_cast<GLsizei>(commands.size()), 0);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+            return;
+        }
+#endif
+        for (const DrawElementsIndirectCommand& command : commands) {
+            bindInstanceAttributes(instanceBuffer, command.baseInstance);
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(command.count), indexType,
+                                              (void*)(static_cast<size_t>(command.firstIndex) * indexSize()),
+                                              static_cast<GLsizei>(command.instanceCount), command.baseVertex);
+        }
+    }
+
+    GLuint vao() const { return vertexArray; }
+    const GeometryArenaStats& statistics() const { return stats; }
+    size_t vertexCount() const { return vertexUsed; }
+    size_t indexCount() const { return indexUsed; }
+
+    void release() {
+        if (!vertexArray) return;
+        glDeleteVertexArrays(1, &vertexArray);
+        glDeleteBuffers(1, &vertexBuffer);
+        glDeleteBuffers(1, &indexBuffer);
+        glDeleteBuffers(1, &instanceBuffer);
+        if (indirectBuffer) glDeleteBuffers(1, &indirectBuffer);
+        vertexArray = vertexBuffer = indexBuffer = instanceBuffer = indirectBuffer = 0;
+        vertexUsed = indexUsed = 0;
+    }
+
+    // GL 4.3, ou les deux extensions (baseInstance sert a decaler les attributs d'instance)
+    static bool multiDrawSupported() {
+#if defined(GL_VERSION_4_3) || defined(GL_ARB_multi_draw_indirect)
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        if (major > 4 || (major == 4 && minor >= 3)) return true;
+        bool indirect = false, baseInstance = false;
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++) {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (!name) continue;
+            if (std::strcmp(name, "GL_ARB_multi_draw_indirect") == 0) indirect = true;
+            if (std::strcmp(name, "GL_ARB_base_instance") == 0) baseInstance = true;
+        }
+        return indirect && baseInstance;
+#else
+        return false;
+#endif
+    }
+
+private:
+    VertexLayout layout;
+    GLenum indexType;
+    GLuint vertexArray = 0, vertexBuffer = 0, indexBuffer = 0, instanceBuffer = 0, indirectBuffer = 0;
+    size_t vertexUsed = 0, indexUsed = 0;
+    size_t vertexCapacityCount = 0, indexCapacityCount = 0;
+    size_t instanceCapacity = 0;
+    bool multiDraw = false;
+
+    std::vector<DrawElementsIndirectCommand> commands;
+    std::vector<InstanceData> instances;
+    GeometryArenaStats stats;
+
+    size_t vertexSize() const { return layout == VertexLayout::Packed ? sizeof(PackedVertex) : sizeof(Vertex); }
+    size_t indexSize() const { return indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t); }
+
+    // locations du vertex shader : 0 = position, 1 = normale, 2 = coord de texture, 3 a 10 = instance
+    void setupVertexArray() {
+        glBindVertexArray(vertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+        if (layout == VertexLayout::Packed) {
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, Position));
+
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, Normal));
+
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, TexCoords));
+        } else {
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Position));
+
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
+
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+        }
+        enableInstanceAttributes();
+        bindInstanceAttributes(instanceBuffer, 0);
+        glBindVertexArray(0);
+    }
+
+    // agrandit un buffer en conservant son contenu (copie GPU -> GPU)
+    static void grow(GLuint& buffer, size_t usedBytes, size_t newBytes) {
+        GLuint bigger = 0;
+        glGenBuffers(1, &bigger);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, bigger);
+        glBufferData(GL_COPY_WRITE_BUFFER, newBytes, nullptr, GL_STATIC_DRAW);
+        if (usedBytes > 0) {
+            glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, usedBytes);
+        }
+        glDeleteBuffers(1, &buffer);
+        buffer = bigger;
+    }
+
+    void reserve(size_t vertices, size_t indices) {
+        bool changed = false;
+        if (vertices > vertexCapacityCount) {
+            size_t capacity = std::max(vertices, vertexCapacityCount * 2);
+            grow(vertexBuffer, vertexUsed * vertexSize(), capacity * vertexSize());
+            vertexCapacityCount = capacity;
+            changed = true;
+        }
+        if (indices > indexCapacityCount) {
+            size_t capacity = std::max(indices, indexCapacityCount * 2);
+            grow(indexBuffer, indexUsed * indexSize(), capacity * indexSize());
+            indexCapacityCount = capacity;
+            changed = true;
+        }
+        if (changed) setupVertexArray(); // le VAO pointait sur les anciens buffers
+    }
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// hash 64 bits d'un bloc d'octets (mots de 8 octets, melange type murmur)
+// sert de cle aux caches sur disque (MeshCache, ShaderCache) : ne pas changer sans changer leur Version
+inline uint64_t hashBytes(const char* data, size_t size) {
+    const uint64_t m = 0xC6A4A7935BD1E995ull;
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ (size * m);
+    size_t words = size / 8;
+    for (size_t i = 0; i < words; i++) {
+        uint64_t k;
+        std::memcpy(&k, data + i * 8, 8);
+        k *= m; k ^= k >> 47; k *= m;
+        h ^= k; h *= m;
+    }
+    uint64_t tail = 0;
+    if (size > words * 8) std::memcpy(&tail, data + words * 8, size - words * 8);
+    h ^= tail; h *= m;
+    h ^= h >> 47; h *= m; h ^= h >> 47;
+    return h;
+}
+
+#endif
@@ -0,0 +1,271 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <glad.h>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Camera.h"
+
+#ifdef ENGINE_HEADLESS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+// point de passage d'un chemin de camera
+struct CameraKey {
+    float time;          // secondes depuis le debut du chemin
+    glm::vec3 position;
+    float yaw, pitch;    // degres, comme Camera
+};
+
+// chemin de camera rejoue en mode sans fenetre
+// fichier texte, une cle par ligne : temps x y z yaw pitch (lignes vides et # ignorees)
+// entre deux cles, position et angles sont interpoles lineairement
+class CameraPath {
+public:
+    bool load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << "Chemin de camera introuvable : " << path << std::endl;
+            return false;
+        }
+        keys.clear();
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line)) {
+            lineNumber++;
+            size_t start = line.find_first_not_of(" \t\r");
+            if (start == std::string::npos || line[start] == '#') continue;
+            std::istringstream stream(line);
+            CameraKey key;
+            if (!(stream >> key.time >> key.position.x >> key.position.y >> key.position.z >> key.yaw >> key.pitch)) {
+                std::cerr << path << ":" << lineNumber << " : cle invalide (temps x y z yaw pitch)" << std::endl;
+                return false;
+            }
+            if (!keys.empty() && key.time < keys.back().time) {
+                std::cerr << path << ":" << lineNumber << " : temps decroissant" << std::endl;
+                return false;
+            }
+            keys.push_back(key);
+        }
+        if (keys.empty()) {
+            std::cerr << "Chemin de camera vide : " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // place la camera au temps t (bornee aux extremites du chemin)
+    void apply(Camera& camera, float t) const {
+        if (keys.empty()) return;
+        if (t <= keys.front().time) return set(camera, keys.front());
+        if (t >= keys.back().time) return set(camera, keys.back());
+        size_t next = 1;
+        while (keys[next].time < t) next++;
+        const CameraKey& a = keys[next - 1];
+        const CameraKey& b = keys[next];
+        float span = b.time - a.time;
+        float f = span > 0.0f ? (t - a.time) / span : 1.0f;
+        camera.SetPose(glm::mix(a.position, b.position, f), a.yaw + (b.yaw - a.yaw) * f, a.pitch + (b.pitch - a.pitch) * f);
+    }
+
+    float duration() const { return keys.empty() ? 0.0f : keys.back().time; }
+    size_t size() const { return keys.size(); }
+
+private:
+    std::vector<CameraKey> keys;
+
+    static void set(Camera& camera, const CameraKey& key) { camera.SetPose(key.position, key.yaw, key.pitch); }
+};
+
+// temps mesures par frame et resume en percentiles (JSON pour la CI)
+class BenchmarkReport {
+public:
+    struct Sample {
+        double frameMs;   // frame complete (GPU attendu en fin de frame)
+        double cpuMs;     // jusqu'a la fin de la soumission
+        double gpuMs;     // GL_TIME_ELAPSED, -1 si la requete n'a pas pu etre lue
+        uint64_t draws;
+    };
+
+    void add(const Sample& sample) { samples.push_back(sample); }
+
+    // complete le temps GPU d'une frame deja ajoutee (les requetes arrivent en retard)
+    void setGpu(size_t index, double gpuMs) {
+        if (index < samples.size()) samples[index].gpuMs = gpuMs;
+    }
+
+    size_t size() const { return samples.size(); }
+
+    // percentile par rang le plus proche (values est trie sur place)
+    static double percentile(std::vector<double>& values, double p) {
+        if (values.empty()) return 0.0;
+        std::sort(values.begin(), values.end());
+        size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(values.size()) + 0.5);
+        return values[std::min(values.size() - 1, rank > 0 ? rank - 1 : 0)];
+    }
+
+    bool writeJSON(const std::string& path, const std::string& cameraPath, const std::string& renderer, size_t warmup) const {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) {
+            std::cerr << "Benchmark : impossible d'ecrire " << path << std::endl;
+            return false;
+        }
+        std::vector<double> frame, cpu, gpu;
+        double totalMs = 0.0;
+        uint64_t draws = 0;
+        for (const Sample& s : samples) {
+            frame.push_back(s.frameMs);
+            cpu.push_back(s.cpuMs);
+            if (s.gpuMs >= 0.0) gpu.push_back(s.gpuMs);
+            totalMs += s.frameMs;
+            draws += s.draws;
+        }
+        double seconds = totalMs / 1000.0;
+
+        out.setf(std::ios::fixed);
+        out.precision(4);
+        out << "{\n";
+        out << "  \"camera_path\": \"" << escape(cameraPath) << "\",\n";
+        out << "  \"renderer\": \"" << escape(renderer) << "\",\n";
+        out << "  \"warmup_frames\": " << warmup << ",\n";
+        out << "  \"frames\": " << samples.size() << ",\n";
+        out << "  \"seconds\": " << seconds << ",\n";
+        out << "  \"fps\": " << (seconds > 0.0 ? samples.size() / seconds : 0.0) << ",\n";
+        out << "  \"draws_per_second\": " << (seconds > 0.0 ? draws / seconds : 0.0) << ",\n";
+        writeSeries(out, "frame_ms", frame);
+        out << ",\n";
+        writeSeries(out, "cpu_ms", cpu);
+        out << ",\n";
+        writeSeries(out, "gpu_ms", gpu);
+        out << "\n}\n";
+        return static_cast<bool>(out);
+    }
+
+private:
+    std::vector<Sample> samples;
+
+    static void writeSeries(std::ostream& out, const char* name, std::vector<double> values) {
+        double mean = 0.0;
+        for (double v : values) mean += v;
+        if (!values.empty()) mean /= static_cast<double>(values.size());
+        out << "  \"" << name << "\": { \"samples\": " << values.size() << ", \"mean\": " << mean
+            << ", \"p50\": " << percentile(values, 50.0) << ", \"p95\": " << percentile(values, 95.0)
+            << ", \"p99\": " << percentile(values, 99.0) << ", \"max\": " << (values.empty() ? 0.0 : values.back()) << " }";
+    }
+
+    static std::string escape(const std::string& text) {
+        std::string result;
+        for (char c : text) {
+            if (c == '"' || c == '\\') result += '\\';
+            result += c;
+        }
+        return result;
+    }
+};
+
+#ifdef ENGINE_HEADLESS
+// contexte GL 3.3 core sans fenetre (EGL, sans surface) et FBO de rendu
+// fonctionne avec les pilotes Mesa (llvmpipe compris) : EGL_PLATFORM_SURFACELESS_MESA si
+// disponible, sinon l'affichage par defaut
+class HeadlessContext {
+public:
+    HeadlessContext() = default;
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+    ~HeadlessContext() { release(); }
+
+    bool init(int width, int height) {
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay) display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+        EGLint major = 0, minor = 0;
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+            std::cerr << "EGL : aucun affichage" << std::endl;
+            return false;
+        }
+        if (!eglBindAPI(EGL_OPENGL_API)) {
+            std::cerr << "EGL : OpenGL non supporte" << std::endl;
+            return false;
+        }
+
+        const EGLint configAttributes[] = {
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_NONE
+        };
+        EGLConfig config = nullptr;
+        EGLint configCount = 0;
+        eglChooseConfig(display, configAttributes, &config, 1, &configCount);
+
+        const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        // sans config (EGL_KHR_no_config_context), le contexte ne sert qu'aux FBO, ce qui suffit ici
+        context = eglCreateContext(display, configCount > 0 ? config : EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+        if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+            std::cerr << "EGL : impossible de creer un contexte GL 3.3 sans surface" << std::endl;
+            return false;
+        }
+        if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+            std::cerr << "EGL : chargement des fonctions GL impossible" << std::endl;
+            return false;
+        }
+
+        // cible de rendu : couleur + profondeur
+        glGenFramebuffers(1, &framebuffer);
+        glGenRenderbuffers(1, &colorBuffer);
+        glGenRenderbuffers(1, &depthBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "FBO incomplet" << std::endl;
+            return false;
+        }
+        glViewport(0, 0, width, height);
+
+        const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+        rendererName = renderer ? renderer : "?";
+        std::cout << "Sans fenetre : EGL " << major << "." << minor << ", " << rendererName << ", " << width << "x" << height << std::endl;
+        return true;
+    }
+
+    const std::string& renderer() const { return rendererName; }
+
+    void release() {
+        if (display == EGL_NO_DISPLAY) return;
+        if (context != EGL_NO_CONTEXT) {
+            glDeleteFramebuffers(1, &framebuffer);
+            glDeleteRenderbuffers(1, &colorBuffer);
+            glDeleteRenderbuffers(1, &depthBuffer);
+            eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            eglDestroyContext(display, context);
+        }
+        eglTerminate(display);
+        display = EGL_NO_DISPLAY;
+        context = EGL_NO_CONTEXT;
+    }
+
+private:
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+    GLuint framebuffer = 0, colorBuffer = 0, depthBuffer = 0;
+    std::string rendererName;
+};
+#endif
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef INSTANCE_DATA_H
+#define INSTANCE_DATA_H
+
+#include <glad.h>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include "Mesh.h"
+
+// donnees par instance lues par le vertex shader (locations 3 a 10)
+// le decodage des sommets compresses voyage avec l'instance : des maillages aux bornes
+// differentes peuvent ainsi partir dans un meme appel de dessin
+struct InstanceData {
+    glm::mat4 transform;        // 3 a 6 : matrice modele
+    glm::vec4 material;         // 7 : x = couche du TextureArray, y = normales octaedriques (0 ou 1)
+    glm::vec4 positionScale;    // 8 : position = aPos * scale + offset (xyz)
+    glm::vec4 positionOffset;   // 9
+    glm::vec4 texcoordDecode;   // 10 : xy = echelle, zw = decalage
+};
+
+inline InstanceData makeInstance(const glm::mat4& transform, float layer, const VertexDecode& decode) {
+    InstanceData instance;
+    instance.transform = transform;
+    instance.material = glm::vec4(layer, decode.octNormals ? 1.0f : 0.0f, 0.0f, 0.0f);
+    // decode.position = translation(min) * echelle(etendue) : diagonale + derniere colonne
+    instance.positionScale = glm::vec4(decode.position[0][0], decode.position[1][1], decode.position[2][2], 0.0f);
+    instance.positionOffset = glm::vec4(glm::vec3(decode.position[3]), 0.0f);
+    instance.texcoordDecode = decode.texcoord;
+    return instance;
+}
+
+const GLuint FirstInstanceAttribute = 3;
+const GLuint InstanceAttributeCount = 8;
+
+// a faire une fois par VAO : attributs d'instance actives, un pas par instance
+inline void enableInstanceAttributes() {
+    for (GLuint i = 0; i < InstanceAttributeCount; i++) {
+        glEnableVertexAttribArray(FirstInstanceAttribute + i);
+        glVertexAttribDivisor(FirstInstanceAttribute + i, 1);
+    }
+}
+
+// attributs d'instance sur buffer a partir de l'instance first (VAO deja lie)
+inline void bindInstanceAttributes(GLuint buffer, size_t first) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    const size_t base = first * sizeof(InstanceData);
+    // InstanceData = 8 vec4 consecutifs (4 colonnes de matrice puis 4 vecteurs)
+    for (GLuint i = 0; i < InstanceAttributeCount; i++) {
+        glVertexAttribPointer(FirstInstanceAttribute + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(base + i * sizeof(glm::vec4)));
+    }
+}
+
+static_assert(sizeof(InstanceData) == InstanceAttributeCount * sizeof(glm::vec4), "InstanceData : 8 vec4 sans padding");
+
+#endif
@@ -0,0 +1,463 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+struct Job;
+
+// compteur de taches en cours : sert de dependance (on attend qu'il retombe a 0,
+// ou on y accroche des suites avec JobSystem::runAfter)
+class JobCounter {
+public:
+    // faux tant que la derniere tache n'a pas fini de lancer les suites du compteur :
+    // une fois vrai, plus aucun thread du systeme ne touche au compteur (il peut etre detruit)
+    bool done() const {
+        return pending.load(std::memory_order_acquire) == 0 && continuations.load(std::memory_order_acquire) == closed();
+    }
+
+private:
+    friend class JobSystem;
+    std::atomic<int> pending{ 0 };
+    // suites en attente (liste chainee par Job::next) ; closed() = compteur a 0 et suites lancees
+    std::atomic<Job*> continuations{ closed() };
+
+    static Job* closed() { return reinterpret_cast<Job*>(static_cast<uintptr_t>(1)); }
+};
+
+// tache : l'appelable est range dans la tache si sa taille le permet, sinon sur le tas
+// les taches sont recyclees par le pool du thread qui les a creees : pas d'allocation par tache
+struct Job {
+    static const size_t InlineSize = 32;
+
+    alignas(std::max_align_t) unsigned char storage[InlineSize];
+    void (*invoke)(Job&);
+    void (*destroy)(Job&);
+    JobCounter* counter;
+    Job* next;          // liste libre du pool, ou suites d'un compteur
+    unsigned int pool;  // pool proprietaire
+};
+
+// taches libres d'un thread : le proprietaire prend dans sa liste privee ; les taches terminees
+// ailleurs reviennent sur une pile atomique qu'il recupere d'un bloc (exchange : pas d'ABA)
+// le pool grossit par blocs jusqu'au nombre max de taches en vol, puis n'alloue plus
+class JobPool {
+public:
+    static const size_t BlockSize = 256;
+
+    // proprietaire uniquement
+    Job* take(unsigned int index) {
+        if (!freeList) freeList = returned.exchange(nullptr, std::memory_order_acquire);
+        if (!freeList) {
+            blocks.emplace_back(new Job[BlockSize]);
+            Job* block = blocks.back().get();
+            for (size_t i = 0; i < BlockSize; i++) {
+                block[i].pool = index;
+                block[i].next = i + 1 < BlockSize ? &block[i + 1] : nullptr;
+            }
+            freeList = block;
+        }
+        Job* job = freeList;
+        freeList = job->next;
+        return job;
+    }
+
+    // n'importe quel thread
+    void give(Job* job) {
+        Job* head = returned.load(std::memory_order_relaxed);
+        do {
+            job->next = head;
+        } while (!returned.compare_exchange_weak(head, job, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+private:
+    Job* freeList = nullptr;
+    alignas(64) std::atomic<Job*> returned{ nullptr };
+    std::vector<std::unique_ptr<Job[]>> blocks;
+};
+
+// file FIFO de taches qui garde sa capacite (std::deque libere et realloue ses blocs en continu)
+class JobQueue {
+public:
+    bool empty() const { return head == items.size(); }
+
+    void push(Job* job) {
+        if (head > 0 && head * 2 >= items.size()) {
+            // la moitie avant est deja consommee : on recale au debut sans reallouer
+            items.erase(items.begin(), items.begin() + static_cast<std::ptrdiff_t>(head));
+            head = 0;
+        }
+        items.push_back(job);
+    }
+
+    Job* pop() {
+        Job* job = items[head++];
+        if (head == items.size()) {
+            items.clear();
+            head = 0;
+        }
+        return job;
+    }
+
+    // premiere tache de counter (l'ordre des autres est conserve), nullptr si aucune
+    Job* take(const JobCounter* counter) {
+        for (size_t i = head; i < items.size(); i++) {
+            if (items[i]->counter != counter) continue;
+            Job* job = items[i];
+            items.erase(items.begin() + static_cast<std::ptrdiff_t>(i));
+            if (head == items.size()) {
+                items.clear();
+                head = 0;
+            }
+            return job;
+        }
+        return nullptr;
+    }
+
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t i = head; i < items.size(); i++) fn(items[i]);
+    }
+
+private:
+    std::vector<Job*> items;
+    size_t head = 0;
+};
+
+// deque de Chase-Lev (version de Le, Pop, Cohen & Zappa Nardelli) a capacite fixe :
+// le proprietaire empile et depile en bas, les autres threads volent en haut
+class WorkStealingDeque {
+public:
+    static const int64_t Capacity = 4096;
+
+    WorkStealingDeque() {
+        for (auto& item : items) item.store(nullptr, std::memory_order_relaxed);
+    }
+
+    // proprietaire uniquement ; faux si la deque est pleine
+    bool push(Job* job) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        if (b - t >= Capacity) return false;
+        items[b & Mask].store(job, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // proprietaire uniquement (LIFO : la tache la plus chaude en cache)
+    Job* pop() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Job* job = items[b & Mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            // dernier element : course possible avec un voleur
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // n'importe quel thread (FIFO : les plus grosses taches en premier)
+    Job* steal() {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        Job* job = items[t & Mask].load(std::memory_order_acquire);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+        return job;
+    }
+
+private:
+    static const int64_t Mask = Capacity - 1;
+    alignas(64) std::atomic<int64_t> top{ 0 };
+    alignas(64) std::atomic<int64_t> bottom{ 0 };
+    std::atomic<Job*> items[Capacity];
+};
+
+// pool fixe de threads avec une deque par thread et vol de taches
+// les threads hors pool (principal, physique) deposent dans une file partagee ; quand ils attendent
+// un compteur ils n'executent que les taches de ce compteur
+// les taches longues (decodage, E/S) passent par runBackground : une file a part que seuls les
+// workers prennent, quand ils n'ont rien d'autre
+class JobSystem {
+public:
+    // threads = nb total de threads qui executent des taches, appelant compris (0 = nb de coeurs)
+    explicit JobSystem(unsigned int threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        workerCount = threads - 1;
+        if (workerCount > 0) {
+            // un pool par worker + un pour les threads exterieurs (sous injectMutex)
+            for (unsigned int i = 0; i <= workerCount; i++) pools.emplace_back(new JobPool());
+        }
+        for (unsigned int i = 0; i < workerCount; i++) deques.emplace_back(new WorkStealingDeque());
+        for (unsigned int i = 0; i < workerCount; i++) workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) worker.join();
+        // taches jamais executees
+        injected.forEach([this](Job* job) { recycle(job); });
+        background.forEach([this](Job* job) { recycle(job); });
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // systeme partage par tout le moteur (cree au premier appel)
+    static JobSystem& instance() {
+        static JobSystem system;
+        return system;
+    }
+
+    unsigned int threadCount() const { return workerCount + 1; }
+
+    // lance fn ; counter (optionnel) reste > 0 tant qu'elle n'est pas terminee
+    template <typename Fn>
+    void run(Fn&& fn, JobCounter* counter = nullptr) {
+        if (workerCount == 0) { fn(); return; } // machine a un seul thread : personne d'autre ne la prendrait
+        submit(create(std::forward<Fn>(fn), counter), false);
+    }
+
+    // tache longue (decodage, lecture de fichier) : jamais prise par un thread qui attend un autre compteur,
+    // ni avant les taches ordinaires
+    template <typename Fn>
+    void runBackground(Fn&& fn, JobCounter* counter = nullptr) {
+        if (workerCount == 0) { fn(); return; }
+        submit(create(std::forward<Fn>(fn), counter), true);
+    }
+
+    // lance fn une fois que dependency est termine (les taches de dependency doivent deja etre lancees)
+    // fn est accrochee au compteur et soumise par la tache qui le fait tomber a 0 : aucun thread n'attend
+    template <typename Fn>
+    void runAfter(JobCounter& dependency, Fn&& fn, JobCounter* counter = nullptr) {
+        if (workerCount == 0) { fn(); return; } // tout s'execute sur place : dependency est deja termine
+        Job* job = create(std::forward<Fn>(fn), counter);
+        Job* head = dependency.continuations.load(std::memory_order_acquire);
+        for (;;) {
+            if (head == JobCounter::closed()) {
+                submit(job, false);
+                return;
+            }
+            job->next = head;
+            if (dependency.continuations.compare_exchange_weak(head, job, std::memory_order_acq_rel, std::memory_order_acquire)) return;
+        }
+    }
+
+    // attend que le compteur retombe a 0 ; un worker execute d'autres taches ordinaires en attendant,
+    // un thread exterieur seulement celles de ce compteur encore dans les files partagees
+    void wait(JobCounter& counter) {
+        int index = currentWorker();
+        while (!counter.done()) {
+            Job* job = index >= 0 ? findJob(index, false) : nullptr;
+            if (!job) job = takeShared(&counter); // y compris ses taches de fond
+            if (job) execute(job);
+            else std::this_thread::yield();
+        }
+    }
+
+    // fn(debut, fin) sur des tranches de grain elements ; l'appelant traite la premiere tranche
+    // les taches ne gardent qu'une reference sur fn : aucune allocation
+    template <typename Fn>
+    void parallelFor(size_t begin, size_t end, size_t grain, Fn&& fn) {
+        if (end <= begin) return;
+        grain = std::max<size_t>(grain, 1);
+        size_t chunks = (end - begin + grain - 1) / grain;
+        if (chunks <= 1 || workerCount == 0) {
+            fn(begin, end);
+            return;
+        }
+        JobCounter counter;
+        for (size_t c = 1; c < chunks; c++) {
+            size_t b = begin + c * grain, e = std::min(end, b + grain);
+            run([&fn, b, e]() { fn(b, e); }, &counter);
+        }
+        fn(begin, std::min(end, begin + grain));
+        wait(counter);
+    }
+
+    // decoupe automatique : ~4 tranches par thread, au moins minGrain elements chacune
+    template <typename Fn>
+    void parallelFor(size_t begin, size_t end, Fn&& fn, size_t minGrain = 1) {
+        size_t grain = std::max(minGrain, (end - begin) / (threadCount() * 4) + 1);
+        parallelFor(begin, end, grain, std::forward<Fn>(fn));
+    }
+
+private:
+    unsigned int workerCount = 0;
+    std::vector<std::unique_ptr<JobPool>> pools;
+    std::vector<std::unique_ptr<WorkStealingDeque>> deques;
+    std::vector<std::thread> workers;
+
+    std::mutex injectMutex;
+    JobQueue injected;              // deposees par les threads exterieurs
+    JobQueue background;            // runBackground
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<int> queued{ 0 };   // taches en attente (approximatif, sert au reveil)
+    bool stopping = false;
+
+    struct WorkerSlot {
+        const JobSystem* owner;
+        int index;
+    };
+
+    static WorkerSlot& slot() {
+        static thread_local WorkerSlot current = { nullptr, -1 };
+        return current;
+    }
+
+    // indice du thread courant dans ce systeme, -1 si thread exterieur
+    int currentWorker() const {
+        const WorkerSlot& s = slot();
+        return s.owner == this ? s.index : -1;
+    }
+
+    // range l'appelable dans une tache du pool du thread courant et compte la tache dans counter
+    template <typename Fn>
+    Job* create(Fn&& fn, JobCounter* counter) {
+        typedef typename std::decay<Fn>::type Callable;
+        Job* job;
+        int index = currentWorker();
+        if (index >= 0) {
+            job = pools[index]->take(static_cast<unsigned int>(index));
+        } else {
+            std::lock_guard<std::mutex> lock(injectMutex); // le pool exterieur est partage
+            job = pools[workerCount]->take(workerCount);
+        }
+
+        if constexpr (sizeof(Callable) <= Job::InlineSize && alignof(Callable) <= alignof(std::max_align_t)) {
+            new (job->storage) Callable(std::forward<Fn>(fn));
+            job->invoke = [](Job& j) { (*std::launder(reinterpret_cast<Callable*>(j.storage)))(); };
+            job->destroy = [](Job& j) { std::launder(reinterpret_cast<Callable*>(j.storage))->~Callable(); };
+        } else {
+            Callable* callable = new Callable(std::forward<Fn>(fn));
+            std::memcpy(job->storage, &callable, sizeof(callable));
+            job->invoke = [](Job& j) { Callable* c; std::memcpy(&c, j.storage, sizeof(c)); (*c)(); };
+            job->destroy = [](Job& j) { Callable* c; std::memcpy(&c, j.storage, sizeof(c)); delete c; };
+        }
+        job->counter = counter;
+        job->next = nullptr;
+        if (counter) acquire(*counter);
+        return job;
+    }
+
+    // une tache de plus sur le compteur
+    static void acquire(JobCounter& counter) {
+        if (counter.pending.fetch_add(1, std::memory_order_acq_rel) != 0) return;
+        // le compteur repart de 0 : on attend que la tache qui l'y a fait tomber ait lance ses suites
+        Job* expected = JobCounter::closed();
+        while (!counter.continuations.compare_exchange_weak(expected, nullptr, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            expected = JobCounter::closed();
+            std::this_thread::yield();
+        }
+    }
+
+    void submit(Job* job, bool lowPriority) {
+        int index = currentWorker();
+        if (index >= 0 && !lowPriority) {
+            if (!deques[index]->push(job)) { execute(job); return; } // deque pleine : on l'execute tout de suite
+        } else {
+            std::lock_guard<std::mutex> lock(injectMutex);
+            (lowPriority ? background : injected).push(job);
+        }
+        queued.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        wake.notify_one();
+    }
+
+    void execute(Job* job) {
+        job->invoke(*job);
+        JobCounter* counter = job->counter;
+        recycle(job);
+        if (!counter || counter->pending.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        // derniere tache du compteur : on ferme la liste des suites et on les lance
+        // (dernier acces au compteur, l'attente peut se terminer juste apres)
+        Job* next = counter->continuations.exchange(JobCounter::closed(), std::memory_order_acq_rel);
+        while (next) {
+            Job* continuation = next;
+            next = continuation->next;
+            submit(continuation, false);
+        }
+    }
+
+    // detruit l'appelable et rend la tache a son pool (sans toucher au compteur)
+    void recycle(Job* job) {
+        job->destroy(*job);
+        pools[job->pool]->give(job);
+    }
+
+    // premiere tache de counter dans les files partagees (file de fond comprise)
+    Job* takeShared(const JobCounter* counter) {
+        std::lock_guard<std::mutex> lock(injectMutex);
+        Job* job = injected.take(counter);
+        if (!job) job = background.take(counter);
+        if (job) queued.fetch_sub(1, std::memory_order_relaxed);
+        return job;
+    }
+
+    Job* findJob(int index, bool allowBackground) {
+        Job* job = deques[index]->pop();
+        if (!job) {
+            std::lock_guard<std::mutex> lock(injectMutex);
+            if (!injected.empty()) job = injected.pop();
+        }
+        if (!job) {
+            // vol : on commence par le voisin pour repartir la contention
+            unsigned int start = static_cast<unsigned int>(index + 1);
+            for (unsigned int i = 0; i < workerCount && !job; i++) {
+                unsigned int victim = (start + i) % workerCount;
+                if (static_cast<int>(victim) != index) job = deques[victim]->steal();
+            }
+        }
+        if (!job && allowBackground) {
+            std::lock_guard<std::mutex> lock(injectMutex);
+            if (!background.empty()) job = background.pop();
+        }
+        if (job) queued.fetch_sub(1, std::memory_order_relaxed);
+        return job;
+    }
+
+    void workerLoop(unsigned int index) {
+        slot() = { this, static_cast<int>(index) };
+        for (;;) {
+            Job* job = findJob(static_cast<int>(index), true);
+            if (job) {
+                execute(job);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            if (stopping) return;
+            wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+            if (stopping) return;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// fichier projete en memoire en lecture seule (pas de copie dans un buffer)
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            mData = other.mData;
+            mSize = other.mSize;
+            mOpen = other.mOpen;
+#ifdef _WIN32
+            mFile = other.mFile;
+            mMapping = other.mMapping;
+            other.mFile = INVALID_HANDLE_VALUE;
+            other.mMapping = nullptr;
+#endif
+            other.mData = nullptr;
+            other.mSize = 0;
+            other.mOpen = false;
+        }
+        return *this;
+    }
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        mFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (mFile == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(mFile, &fileSize)) { close(); return false; }
+        mSize = static_cast<size_t>(fileSize.QuadPart);
+        mOpen = true;
+        if (mSize == 0) return true; // fichier vide : rien a projeter
+
+        mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mMapping) { close(); return false; }
+        mData = static_cast<const char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+        if (!mData) { close(); return false; }
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) { ::close(fd); return false; }
+        mSize = static_cast<size_t>(st.st_size);
+        if (mSize == 0) { ::close(fd); mOpen = true; return true; }
+
+        void* ptr = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // la projection reste valide apres fermeture du descripteur
+        if (ptr == MAP_FAILED) { mSize = 0; return false; }
+        madvise(ptr, mSize, MADV_SEQUENTIAL);
+        mData = static_cast<const char*>(ptr);
+        mOpen = true;
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (mData) UnmapViewOfFile(mData);
+        if (mMapping) CloseHandle(mMapping);
+        if (mFile != INVALID_HANDLE_VALUE) CloseHandle(mFile);
+        mMapping = nullptr;
+        mFile = INVALID_HANDLE_VALUE;
+#else
+        if (mData) munmap(const_cast<char*>(mData), mSize);
+#endif
+        mData = nullptr;
+        mSize = 0;
+        mOpen = false;
+    }
+
+    const char* data() const { return mData; }
+    size_t size() const { return mSize; }
+    bool isOpen() const { return mOpen; }
+
+private:
+    const char* mData = nullptr;
+    size_t mSize = 0;
+    bool mOpen = false;
+#ifdef _WIN32
+    HANDLE mFile = INVALID_HANDLE_VALUE;
+    HANDLE mMapping = nullptr;
+#endif
+};
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "MappedFile.h"
+
+// struct d'un sommet
+struct Vertex {
+    glm::vec3 Position;
+    glm::vec3 Normal;
+    glm::vec2 TexCoords;
+};
+
+// sommet compresse (16 octets au lieu de 32), decode dans vertex_shader.glsl
+struct PackedVertex {
+    uint16_t Position[4];   // xyz normalises sur les bornes du maillage (unorm16), w inutilise
+    int16_t Normal[2];      // normale en encodage octaedrique (snorm16)
+    uint16_t TexCoords[2];  // uv normalises sur les bornes uv (unorm16)
+};
+
+// format des sommets envoyes au GPU
+enum class VertexLayout {
+    Float,   // Vertex
+    Packed   // PackedVertex
+};
+
+// parametres pour retrouver les valeurs d'origine dans le shader
+struct VertexDecode {
+    glm::mat4 position = glm::mat4(1.0f);           // unorm -> espace modele
+    glm::vec4 texcoord = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f); // xy = echelle, zw = decalage
+    bool octNormals = false;
+};
+
+// niveau de detail : sous-plage de l'index buffer (tous les LODs partagent les sommets)
+struct MeshLod {
+    uint32_t indexOffset;   // premier indice dans l'EBO
+    uint32_t indexCount;
+    float error;            // erreur quadrique acceptee pour ce niveau (0 pour le LOD 0)
+};
+
+// vue non proprietaire sur un maillage pret a etre envoye au GPU
+// (les donnees viennent soit des vecteurs du chargeur, soit d'un cache projete en memoire)
+struct MeshView {
+    const Vertex* vertices = nullptr;
+    size_t vertexCount = 0;
+    const void* indices = nullptr;
+    size_t indexCount = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+    glm::vec3 minBounds = glm::vec3(0.0f);
+    glm::vec3 maxBounds = glm::vec3(0.0f);
+    const MeshLod* lods = nullptr;  // LOD 0 = maillage complet
+    size_t lodCount = 0;
+
+    size_t indexSize() const { return indexType == GL_UNSIGNED_SHORT ? 2 : 4; }
+
+    // indice i quelle que soit la largeur stockee
+    unsigned int index(size_t i) const {
+        if (indexType == GL_UNSIGNED_SHORT) return static_cast<const unsigned short*>(indices)[i];
+        return static_cast<const unsigned int*>(indices)[i];
+    }
+};
+
+// maillage possede en memoire (sortie du chargeur .obj)
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<uint16_t> indices16;      // copie 16 bits des indices si le nb de sommets le permet
+    GLenum indexType = GL_UNSIGNED_INT;   // type d'indice utilise par glDrawElements
+    std::vector<MeshLod> lods;            // plages de l'EBO pour chaque niveau de detail
+
+    MeshView view() const {
+        MeshView mesh;
+        mesh.vertices = vertices.data();
+        mesh.vertexCount = vertices.size();
+        mesh.indexType = indexType;
+        mesh.indexCount = indices.size();
+        mesh.indices = indexType == GL_UNSIGNED_SHORT ? static_cast<const void*>(indices16.data())
+                                                      : static_cast<const void*>(indices.data());
+        mesh.lods = lods.data();
+        mesh.lodCount = lods.size();
+
+        if (!vertices.empty()) {
+            mesh.minBounds = mesh.maxBounds = vertices[0].Position;
+            for (const Vertex& v : vertices) {
+                mesh.minBounds = glm::min(mesh.minBounds, v.Position);
+                mesh.maxBounds = glm::max(mesh.maxBounds, v.Position);
+            }
+        }
+        return mesh;
+    }
+};
+
+// maillage charge : soit projete depuis le cache, soit possede apres lecture du .obj
+// (non deplacable une fois la vue construite : la vue pointe dans mapping ou data)
+struct MeshAsset {
+    MappedFile mapping;
+    MeshData data;
+    MeshView view;
+};
+
+#endif
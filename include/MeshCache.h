@@ -0,0 +1,216 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "Hash.h"
+#include "Mesh.h"
+#include "MappedFile.h"
+
+// cache binaire d'un maillage ecrit a cote du .obj (modele.obj -> modele.obj.meshcache)
+// disposition : en-tete | sommets entrelaces (Vertex) | indices (16 ou 32 bits, tous les LODs) | table des LODs
+// le fichier est projete en memoire au chargement et envoye tel quel a glBufferData
+class MeshCache {
+public:
+    static const uint32_t Version = 3;
+
+    struct Header {
+        char magic[4];          // "EYMC"
+        uint32_t version;
+        uint32_t vertexSize;    // sizeof(Vertex) a l'ecriture
+        uint32_t indexSize;     // 2 ou 4 octets
+        uint64_t vertexCount;
+        uint64_t indexCount;
+        float minBounds[3];
+        float maxBounds[3];
+        uint64_t sourceSize;    // taille du .obj source
+        int64_t sourceMtime;    // date de modif du .obj source
+        uint64_t contentHash;   // hash du contenu du .obj source
+        uint64_t buildOptions;  // options de construction (Optimized...)
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+        uint64_t lodCount;
+        uint64_t lodOffset;
+    };
+
+    static std::string cachePath(const std::string& sourcePath) {
+        return sourcePath + ".meshcache";
+    }
+
+    // options de construction enregistrees dans le cache : d'autres options le rendent perime
+    static const uint64_t Optimized = 1;   // passes de MeshOptimizer appliquees
+
+    // projette le cache et remplit la vue ; faux si absent, corrompu, incoherent, perime ou construit avec d'autres options
+    // l'en-tete est lu (et sa date mise a jour) avant la projection : Windows refuse d'ecrire dans un fichier projete
+    static bool load(const std::string& sourcePath, uint64_t options, MappedFile& mapping, MeshView& mesh) {
+        std::string path = cachePath(sourcePath);
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec)) return false;
+
+        Header header;
+        {
+            std::ifstream in(path, std::ios::binary);
+            if (!in.read(reinterpret_cast<char*>(&header), sizeof(Header))) return false;
+        }
+        if (std::memcmp(header.magic, "EYMC", 4) != 0 || header.version != Version ||
+            header.vertexSize != sizeof(Vertex) || (header.indexSize != 2 && header.indexSize != 4)) {
+            std::cout << "Cache " << path << " : format obsolete, reconstruction" << std::endl;
+            return false;
+        }
+        if (header.buildOptions != options) {
+            std::cout << "Cache " << path << " : options de construction differentes, reconstruction" << std::endl;
+            return false;
+        }
+
+        // invalidation : taille + date d'abord, puis hash si seule la date a change
+        uint64_t sourceSize = 0;
+        int64_t sourceMtime = 0;
+        if (!sourceStamp(sourcePath, sourceSize, sourceMtime) || sourceSize != header.sourceSize) return false;
+        if (sourceMtime != header.sourceMtime) {
+            uint64_t hash = 0;
+            if (!hashFile(sourcePath, hash) || hash != header.contentHash) return false;
+            // contenu identique (fichier juste touche) : on met a jour la date
+            header.sourceMtime = sourceMtime;
+            std::fstream out(path, std::ios::in | std::ios::out | std::ios::binary);
+            if (out) out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        }
+
+        if (!mapping.open(path)) return false;
+        if (!validate(header, mapping)) {
+            std::cerr << "Cache " << path << " : fichier tronque ou incoherent, reconstruction" << std::endl;
+            mapping.close();
+            return false;
+        }
+
+        mesh.vertices = reinterpret_cast<const Vertex*>(mapping.data() + header.vertexOffset);
+        mesh.vertexCount = static_cast<size_t>(header.vertexCount);
+        mesh.indices = mapping.data() + header.indexOffset;
+        mesh.indexCount = static_cast<size_t>(header.indexCount);
+        mesh.indexType = header.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        mesh.minBounds = glm::vec3(header.minBounds[0], header.minBounds[1], header.minBounds[2]);
+        mesh.maxBounds = glm::vec3(header.maxBounds[0], header.maxBounds[1], header.maxBounds[2]);
+        mesh.lods = reinterpret_cast<const MeshLod*>(mapping.data() + header.lodOffset);
+        mesh.lodCount = static_cast<size_t>(header.lodCount);
+        return true;
+    }
+
+    // ecrit le cache (fichier temporaire puis renommage pour ne jamais laisser un cache a moitie ecrit)
+    static bool write(const std::string& sourcePath, uint64_t options, const MeshView& mesh) {
+        Header header = {};
+        std::memcpy(header.magic, "EYMC", 4);
+        header.version = Version;
+        header.vertexSize = sizeof(Vertex);
+        header.buildOptions = options;
+        header.indexSize = static_cast<uint32_t>(mesh.indexSize());
+        header.vertexCount = mesh.vertexCount;
+        header.indexCount = mesh.indexCount;
+        for (int i = 0; i < 3; i++) {
+            header.minBounds[i] = mesh.minBounds[i];
+            header.maxBounds[i] = mesh.maxBounds[i];
+        }
+        if (!sourceStamp(sourcePath, header.sourceSize, header.sourceMtime) ||
+            !hashFile(sourcePath, header.contentHash)) {
+            return false;
+        }
+        header.vertexOffset = alignUp(sizeof(Header), 16);
+        header.indexOffset = alignUp(header.vertexOffset + header.vertexCount * sizeof(Vertex), 16);
+        header.lodCount = mesh.lodCount;
+        header.lodOffset = alignUp(header.indexOffset + header.indexCount * header.indexSize, 16);
+
+        std::string path = cachePath(sourcePath);
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                std::cerr << "Cache : impossible d'ecrire " << tmpPath << std::endl;
+                return false;
+            }
+            const char zeros[16] = {};
+            out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+            out.write(zeros, header.vertexOffset - sizeof(Header));
+            out.write(reinterpret_cast<const char*>(mesh.vertices), mesh.vertexCount * sizeof(Vertex));
+            out.write(zeros, header.indexOffset - (header.vertexOffset + mesh.vertexCount * sizeof(Vertex)));
+            out.write(static_cast<const char*>(mesh.indices), mesh.indexCount * mesh.indexSize());
+            out.write(zeros, header.lodOffset - (header.indexOffset + mesh.indexCount * mesh.indexSize()));
+            out.write(reinterpret_cast<const char*>(mesh.lods), mesh.lodCount * sizeof(MeshLod));
+            if (!out) {
+                std::cerr << "Cache : erreur d'ecriture " << tmpPath << std::endl;
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec) {
+            std::cerr << "Cache : " << ec.message() << std::endl;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    // count elements de size octets a partir de offset tiennent dans fileSize (sans debordement)
+    static bool fits(uint64_t offset, uint64_t count, uint64_t size, uint64_t fileSize) {
+        return offset <= fileSize && count <= (fileSize - offset) / size;
+    }
+
+    template <typename Index>
+    static bool indicesInRange(const char* data, uint64_t count, uint64_t vertexCount) {
+        const Index* indices = reinterpret_cast<const Index*>(data);
+        Index maxIndex = 0;
+        for (uint64_t i = 0; i < count; i++) maxIndex = std::max(maxIndex, indices[i]);
+        return count == 0 || maxIndex < vertexCount;
+    }
+
+    // le cache vient du disque : on verifie tout ce que le rendu lira sans controle
+    // (sections dans le fichier et alignees, au moins un LOD, LODs dans les indices, indices < nb de sommets)
+    static bool validate(const Header& header, const MappedFile& mapping) {
+        const uint64_t fileSize = mapping.size();
+        // l'en-tete projete doit etre celui deja lu (fichier remplace entre les deux sinon)
+        if (fileSize < sizeof(Header) || std::memcmp(mapping.data(), &header, sizeof(Header)) != 0 ||
+            !fits(header.vertexOffset, header.vertexCount, header.vertexSize, fileSize) ||
+            !fits(header.indexOffset, header.indexCount, header.indexSize, fileSize) ||
+            !fits(header.lodOffset, header.lodCount, sizeof(MeshLod), fileSize) ||
+            header.vertexOffset % alignof(Vertex) != 0 || header.indexOffset % header.indexSize != 0 ||
+            header.lodOffset % alignof(MeshLod) != 0) {
+            return false;
+        }
+        if (header.lodCount < 1) return false;
+        const MeshLod* lods = reinterpret_cast<const MeshLod*>(mapping.data() + header.lodOffset);
+        for (uint64_t i = 0; i < header.lodCount; i++) {
+            if (static_cast<uint64_t>(lods[i].indexOffset) + lods[i].indexCount > header.indexCount) return false;
+        }
+        const char* indices = mapping.data() + header.indexOffset;
+        return header.indexSize == 2 ? indicesInRange<uint16_t>(indices, header.indexCount, header.vertexCount)
+                                     : indicesInRange<uint32_t>(indices, header.indexCount, header.vertexCount);
+    }
+
+    static uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    static bool sourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& mtime) {
+        std::error_code ec;
+        size = std::filesystem::file_size(sourcePath, ec);
+        if (ec) return false;
+        auto time = std::filesystem::last_write_time(sourcePath, ec);
+        if (ec) return false;
+        mtime = static_cast<int64_t>(time.time_since_epoch().count());
+        return true;
+    }
+
+    static bool hashFile(const std::string& sourcePath, uint64_t& hash) {
+        MappedFile source;
+        if (!source.open(sourcePath)) return false;
+        hash = hashBytes(source.data(), source.size());
+        return true;
+    }
+};
+
+#endif
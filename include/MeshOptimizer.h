@@ -0,0 +1,245 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Mesh.h"
+
+// resultat de la simulation du cache post-transformation
+struct VertexCacheStats {
+    size_t transforms = 0;  // nb de sommets transformes (defauts de cache)
+    float acmr = 0.0f;      // sommets transformes par triangle (ideal ~0.5, pire 3)
+    float atvr = 0.0f;      // sommets transformes par sommet unique (ideal 1)
+};
+
+// optimisations hors GPU d'un maillage indexe, a passer entre loadOBJ et setupMesh :
+//  1. ordre des triangles pour le cache de sommets (Forsyth)
+//  2. ordre des groupes de triangles pour limiter l'overdraw (tri des clusters de l'exterieur vers l'interieur)
+//  3. ordre des sommets selon le premier usage pour la localite des lectures
+class MeshOptimizer {
+public:
+    // simule un cache FIFO de cacheSize entrees (comportement proche du materiel)
+    static VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                               unsigned int cacheSize = 16) {
+        VertexCacheStats stats;
+        if (indices.empty() || vertexCount == 0) return stats;
+
+        std::vector<unsigned int> timestamps(vertexCount, 0);
+        unsigned int time = cacheSize + 1;
+        for (unsigned int index : indices) {
+            // un sommet est dans le cache s'il a ete insere il y a moins de cacheSize insertions
+            if (time - timestamps[index] > cacheSize) {
+                timestamps[index] = time++;
+                stats.transforms++;
+            }
+        }
+
+        std::vector<char> used(vertexCount, 0);
+        size_t uniqueCount = 0;
+        for (unsigned int index : indices) {
+            if (!used[index]) { used[index] = 1; uniqueCount++; }
+        }
+
+        stats.acmr = static_cast<float>(stats.transforms) / (indices.size() / 3);
+        stats.atvr = static_cast<float>(stats.transforms) / uniqueCount;
+        return stats;
+    }
+
+    // reordonne les triangles pour maximiser les hits du cache post-transformation
+    // (algorithme de Tom Forsyth, "Linear-Speed Vertex Cache Optimisation")
+    static void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+        const size_t triCount = indices.size() / 3;
+        if (triCount == 0) return;
+
+        // adjacence sommet -> triangles (format compresse)
+        std::vector<unsigned int> valence(vertexCount, 0);
+        for (unsigned int index : indices) valence[index]++;
+        std::vector<unsigned int> adjOffset(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; v++) adjOffset[v + 1] = adjOffset[v] + valence[v];
+        std::vector<unsigned int> adjTris(indices.size());
+        std::vector<unsigned int> fill(adjOffset.begin(), adjOffset.end() - 1);
+        for (size_t t = 0; t < triCount; t++)
+            for (int k = 0; k < 3; k++) adjTris[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+
+        std::vector<unsigned int> remaining(valence);  // triangles non emis par sommet
+        std::vector<float> vertexScore(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++) vertexScore[v] = forsythScore(-1, remaining[v]);
+        std::vector<char> emitted(triCount, 0);
+
+        std::vector<unsigned int> output;
+        output.reserve(indices.size());
+        std::vector<unsigned int> cache, newCache;
+        cache.reserve(ForsythCacheSize + 3);
+        newCache.reserve(ForsythCacheSize + 3);
+
+        size_t scanCursor = 0;
+        long bestTri = -1;
+        for (size_t emittedCount = 0; emittedCount < triCount; emittedCount++) {
+            if (bestTri < 0) {
+                // aucun candidat dans le cache : premier triangle restant
+                while (emitted[scanCursor]) scanCursor++;
+                bestTri = static_cast<long>(scanCursor);
+            }
+
+            const unsigned int* tri = &indices[bestTri * 3];
+            emitted[bestTri] = 1;
+            output.insert(output.end(), tri, tri + 3);
+
+            // retire le triangle de l'adjacence de ses sommets
+            for (int k = 0; k < 3; k++) {
+                unsigned int v = tri[k];
+                unsigned int* begin = &adjTris[adjOffset[v]];
+                unsigned int* end = begin + remaining[v];
+                std::iter_swap(std::find(begin, end, static_cast<unsigned int>(bestTri)), end - 1);
+                remaining[v]--;
+            }
+
+            // cache LRU : les sommets du triangle passent devant
+            newCache.assign(tri, tri + 3);
+            for (unsigned int v : cache)
+                if (v != tri[0] && v != tri[1] && v != tri[2]) newCache.push_back(v);
+            for (size_t i = ForsythCacheSize; i < newCache.size(); i++)
+                vertexScore[newCache[i]] = forsythScore(-1, remaining[newCache[i]]); // sort du cache
+            if (newCache.size() > ForsythCacheSize) newCache.resize(ForsythCacheSize);
+            cache.swap(newCache);
+
+            // MAJ des scores des sommets du cache et de leurs triangles, choix du meilleur
+            for (size_t i = 0; i < cache.size(); i++)
+                vertexScore[cache[i]] = forsythScore(static_cast<int>(i), remaining[cache[i]]);
+            bestTri = -1;
+            float bestScore = -1.0f;
+            for (unsigned int v : cache) {
+                for (unsigned int a = adjOffset[v]; a < adjOffset[v] + remaining[v]; a++) {
+                    unsigned int t = adjTris[a];
+                    float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+                    if (score > bestScore) { bestScore = score; bestTri = static_cast<long>(t); }
+                }
+            }
+        }
+
+        indices.swap(output);
+    }
+
+    // reordonne des groupes de triangles (deja optimises pour le cache) pour dessiner
+    // d'abord ceux qui font face vers l'exterieur ; threshold borne la degradation de l'ACMR
+    static void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices,
+                                 float threshold = 1.05f, unsigned int cacheSize = 16) {
+        const size_t triCount = indices.size() / 3;
+        if (triCount == 0) return;
+
+        // coupures "dures" : triangles dont les 3 sommets ratent le cache (le cache repart de zero)
+        std::vector<size_t> clusters;
+        {
+            std::vector<unsigned int> timestamps(vertices.size(), 0);
+            unsigned int time = cacheSize + 1;
+            size_t clusterStart = 0, clusterMisses = 0;
+            float baseAcmr = analyzeVertexCache(indices, vertices.size(), cacheSize).acmr;
+            for (size_t t = 0; t < triCount; t++) {
+                int misses = 0;
+                for (int k = 0; k < 3; k++) {
+                    unsigned int v = indices[t * 3 + k];
+                    if (time - timestamps[v] > cacheSize) { timestamps[v] = time++; misses++; }
+                }
+                // on ne coupe que si le cluster courant a un ACMR acceptable
+                size_t clusterTris = t - clusterStart;
+                if (misses == 3 && clusterTris > 0 &&
+                    static_cast<float>(clusterMisses) / clusterTris <= baseAcmr * threshold) {
+                    clusters.push_back(clusterStart);
+                    clusterStart = t;
+                    clusterMisses = 0;
+                }
+                clusterMisses += misses;
+            }
+            clusters.push_back(clusterStart);
+        }
+        if (clusters.size() < 2) return;
+
+        // centre du maillage
+        glm::vec3 meshCenter(0.0f);
+        for (unsigned int index : indices) meshCenter += vertices[index].Position;
+        meshCenter /= static_cast<float>(indices.size());
+
+        // cle : plus le cluster regarde vers l'exterieur, plus il passe tot
+        std::vector<float> sortKey(clusters.size());
+        for (size_t c = 0; c < clusters.size(); c++) {
+            size_t begin = clusters[c];
+            size_t end = c + 1 < clusters.size() ? clusters[c + 1] : triCount;
+            glm::vec3 centroid(0.0f), normal(0.0f);
+            float area = 0.0f;
+            for (size_t t = begin; t < end; t++) {
+                const glm::vec3& a = vertices[indices[t * 3]].Position;
+                const glm::vec3& b = vertices[indices[t * 3 + 1]].Position;
+                const glm::vec3& d = vertices[indices[t * 3 + 2]].Position;
+                glm::vec3 n = glm::cross(b - a, d - a);
+                float triArea = glm::length(n);
+                centroid += (a + b + d) * (triArea / 3.0f);
+                normal += n;
+                area += triArea;
+            }
+            if (area > 0.0f) centroid /= area;
+            float normalLength = glm::length(normal);
+            if (normalLength > 0.0f) normal /= normalLength;
+            sortKey[c] = glm::dot(centroid - meshCenter, normal);
+        }
+
+        std::vector<size_t> order(clusters.size());
+        for (size_t c = 0; c < order.size(); c++) order[c] = c;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sortKey[a] > sortKey[b]; });
+
+        std::vector<unsigned int> output;
+        output.reserve(indices.size());
+        for (size_t c : order) {
+            size_t begin = clusters[c];
+            size_t end = c + 1 < clusters.size() ? clusters[c + 1] : triCount;
+            output.insert(output.end(), indices.begin() + begin * 3, indices.begin() + end * 3);
+        }
+        indices.swap(output);
+    }
+
+    // renumerote les sommets dans l'ordre de premiere utilisation (les sommets inutilises disparaissent)
+    static void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+        const unsigned int unused = ~0u;
+        std::vector<unsigned int> remap(vertices.size(), unused);
+        std::vector<Vertex> output;
+        output.reserve(vertices.size());
+        for (unsigned int& index : indices) {
+            if (remap[index] == unused) {
+                remap[index] = static_cast<unsigned int>(output.size());
+                output.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+        vertices.swap(output);
+    }
+
+private:
+    static const size_t ForsythCacheSize = 32;
+
+    static float forsythScore(int cachePosition, unsigned int remainingTris) {
+        if (remainingTris == 0) return -1.0f; // plus aucun triangle : sans interet
+
+        const float CacheDecayPower = 1.5f;
+        const float LastTriScore = 0.75f;
+        const float ValenceBoostScale = 2.0f;
+        const float ValenceBoostPower = 0.5f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                // sommets du dernier triangle : score fixe pour eviter de favoriser les bandes
+                score = LastTriScore;
+            } else {
+                const float scaler = 1.0f / (ForsythCacheSize - 3);
+                score = std::pow(1.0f - (cachePosition - 3) * scaler, CacheDecayPower);
+            }
+        }
+        // bonus pour les sommets qui ont peu de triangles restants (on les termine vite)
+        score += ValenceBoostScale * std::pow(static_cast<float>(remainingTris), -ValenceBoostPower);
+        return score;
+    }
+};
+
+#endif
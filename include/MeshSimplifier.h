@@ -0,0 +1,257 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Mesh.h"
+
+// simplification par fusion d'aretes guidee par les quadriques d'erreur (Garland & Heckbert)
+// fusion "demi-arete" : un sommet u est remplace par un voisin v existant, donc les LODs
+// partagent le meme tableau de sommets et seul l'index buffer change
+class MeshSimplifier {
+public:
+    // renvoie des indices avec au plus ~targetIndexCount indices (moins si le maillage le permet)
+    // resultError recoit l'erreur quadrique max acceptee (distance au carre, unites du modele)
+    static std::vector<unsigned int> simplify(const Vertex* vertices, size_t vertexCount,
+                                              const std::vector<unsigned int>& indices,
+                                              size_t targetIndexCount, float* resultError = nullptr) {
+        const size_t triCount = indices.size() / 3;
+        if (resultError) *resultError = 0.0f;
+        if (targetIndexCount >= indices.size() || triCount == 0) return indices;
+
+        // sommets a la meme position = un seul sommet topologique (les "wedges" d'une couture uv)
+        std::vector<unsigned int> canonical(vertexCount);
+        {
+            std::unordered_map<PositionKey, unsigned int, PositionKeyHash> positions;
+            positions.reserve(vertexCount);
+            for (size_t i = 0; i < vertexCount; i++) {
+                auto res = positions.emplace(PositionKey(vertices[i].Position), static_cast<unsigned int>(i));
+                canonical[i] = res.first->second;
+            }
+        }
+
+        std::vector<unsigned int> tris(indices);
+        std::vector<char> triAlive(triCount, 1);
+
+        // triangles par sommet topologique
+        std::vector<std::vector<unsigned int>> vertexTris(vertexCount);
+        for (size_t t = 0; t < triCount; t++)
+            for (int k = 0; k < 3; k++) vertexTris[canonical[tris[t * 3 + k]]].push_back(static_cast<unsigned int>(t));
+
+        // quadriques : somme des plans des triangles voisins, ponderes par l'aire
+        std::vector<Quadric> quadrics(vertexCount);
+        for (size_t t = 0; t < triCount; t++) {
+            const glm::vec3& a = vertices[tris[t * 3]].Position;
+            const glm::vec3& b = vertices[tris[t * 3 + 1]].Position;
+            const glm::vec3& c = vertices[tris[t * 3 + 2]].Position;
+            glm::vec3 n = glm::cross(b - a, c - a);
+            float area = glm::length(n);
+            if (area <= 0.0f) continue;
+            n /= area;
+            Quadric q = Quadric::fromPlane(n, -glm::dot(n, a), area * 0.5f);
+            for (int k = 0; k < 3; k++) quadrics[canonical[tris[t * 3 + k]]].add(q);
+        }
+
+        // sommets verrouilles : bords ouverts et coutures (plusieurs wedges a la meme position)
+        std::vector<char> locked(vertexCount, 0);
+        {
+            // on ne compte que les wedges reellement utilises par des triangles
+            std::vector<unsigned int> wedgeCount(vertexCount, 0);
+            std::vector<char> used(vertexCount, 0);
+            for (unsigned int index : tris) used[index] = 1;
+            for (size_t i = 0; i < vertexCount; i++)
+                if (used[i]) wedgeCount[canonical[i]]++;
+            for (size_t i = 0; i < vertexCount; i++)
+                if (wedgeCount[i] > 1) locked[i] = 1;
+
+            std::unordered_map<uint64_t, unsigned int> edgeUse;
+            edgeUse.reserve(indices.size());
+            for (size_t t = 0; t < triCount; t++)
+                for (int k = 0; k < 3; k++)
+                    edgeUse[edgeKey(canonical[tris[t * 3 + k]], canonical[tris[t * 3 + (k + 1) % 3]])]++;
+            for (const auto& e : edgeUse) {
+                if (e.second != 2) {
+                    locked[static_cast<unsigned int>(e.first >> 32)] = 1;
+                    locked[static_cast<unsigned int>(e.first & 0xFFFFFFFFu)] = 1;
+                }
+            }
+        }
+
+        std::vector<unsigned int> version(vertexCount, 0);
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+
+        auto pushCollapses = [&](unsigned int u) {
+            // toutes les fusions u -> voisin et voisin -> u
+            for (unsigned int t : vertexTris[u]) {
+                if (!triAlive[t]) continue;
+                for (int k = 0; k < 3; k++) {
+                    unsigned int w = canonical[tris[t * 3 + k]];
+                    if (w == u) continue;
+                    if (!locked[u]) heap.push(makeCollapse(u, w, vertices, quadrics, version));
+                    if (!locked[w]) heap.push(makeCollapse(w, u, vertices, quadrics, version));
+                }
+            }
+        };
+        for (size_t v = 0; v < vertexCount; v++)
+            if (canonical[v] == v && !locked[v]) pushCollapses(static_cast<unsigned int>(v));
+
+        size_t liveTris = triCount;
+        const size_t targetTris = targetIndexCount / 3;
+        float maxError = 0.0f;
+
+        while (liveTris > targetTris && !heap.empty()) {
+            Collapse c = heap.top();
+            heap.pop();
+            if (version[c.from] != c.fromVersion || version[c.to] != c.toVersion) continue; // entree perimee
+
+            unsigned int u = c.from, v = c.to;
+
+            // wedge de v a utiliser : celui des triangles qui portent l'arete u-v
+            unsigned int targetWedge = ~0u;
+            bool adjacent = false;
+            for (unsigned int t : vertexTris[u]) {
+                if (!triAlive[t]) continue;
+                for (int k = 0; k < 3; k++) {
+                    if (canonical[tris[t * 3 + k]] == v) { targetWedge = tris[t * 3 + k]; adjacent = true; }
+                }
+            }
+            if (!adjacent) continue;
+
+            // refuse les fusions qui retournent un triangle
+            if (flipsTriangle(u, v, vertices, tris, triAlive, canonical, vertexTris[u])) continue;
+
+            for (unsigned int t : vertexTris[u]) {
+                if (!triAlive[t]) continue;
+                unsigned int* tri = &tris[t * 3];
+                bool hasV = canonical[tri[0]] == v || canonical[tri[1]] == v || canonical[tri[2]] == v;
+                if (hasV) {
+                    triAlive[t] = 0; // le triangle devient degenere
+                    liveTris--;
+                } else {
+                    for (int k = 0; k < 3; k++)
+                        if (canonical[tri[k]] == u) tri[k] = targetWedge;
+                    vertexTris[v].push_back(t);
+                }
+            }
+            vertexTris[u].clear();
+            quadrics[v].add(quadrics[u]);
+            version[u]++;
+            version[v]++;
+            maxError = std::max(maxError, c.cost);
+
+            // nettoie la liste de v puis recalcule les fusions autour de v
+            // (seules celles qui touchent v changent : les autres quadriques sont intactes)
+            auto& list = vertexTris[v];
+            list.erase(std::remove_if(list.begin(), list.end(), [&](unsigned int t) { return !triAlive[t]; }), list.end());
+            pushCollapses(v);
+        }
+
+        std::vector<unsigned int> result;
+        result.reserve(liveTris * 3);
+        for (size_t t = 0; t < triCount; t++)
+            if (triAlive[t]) result.insert(result.end(), &tris[t * 3], &tris[t * 3] + 3);
+
+        if (resultError) *resultError = maxError;
+        return result;
+    }
+
+private:
+    // quadrique symetrique 4x4 stockee en 10 coefficients
+    struct Quadric {
+        double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+
+        static Quadric fromPlane(const glm::vec3& n, float d, float weight) {
+            Quadric q;
+            q.a2 = weight * n.x * n.x; q.ab = weight * n.x * n.y; q.ac = weight * n.x * n.z; q.ad = weight * n.x * d;
+            q.b2 = weight * n.y * n.y; q.bc = weight * n.y * n.z; q.bd = weight * n.y * d;
+            q.c2 = weight * n.z * n.z; q.cd = weight * n.z * d;
+            q.d2 = weight * d * d;
+            return q;
+        }
+
+        void add(const Quadric& o) {
+            a2 += o.a2; ab += o.ab; ac += o.ac; ad += o.ad; b2 += o.b2;
+            bc += o.bc; bd += o.bd; c2 += o.c2; cd += o.cd; d2 += o.d2;
+        }
+
+        double error(const glm::vec3& p) const {
+            double x = p.x, y = p.y, z = p.z;
+            return a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+                 + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+                 + c2 * z * z + 2 * cd * z + d2;
+        }
+    };
+
+    struct Collapse {
+        float cost;
+        unsigned int from, to;
+        unsigned int fromVersion, toVersion;
+        bool operator>(const Collapse& o) const { return cost > o.cost; }
+    };
+
+    struct PositionKey {
+        uint32_t bits[3];
+        explicit PositionKey(const glm::vec3& p) { std::memcpy(bits, &p[0], sizeof(bits)); }
+        bool operator==(const PositionKey& o) const {
+            return bits[0] == o.bits[0] && bits[1] == o.bits[1] && bits[2] == o.bits[2];
+        }
+    };
+
+    struct PositionKeyHash {
+        size_t operator()(const PositionKey& k) const {
+            uint64_t h = k.bits[0];
+            h = h * 0x9E3779B97F4A7C15ull ^ k.bits[1];
+            h = h * 0xC2B2AE3D27D4EB4Full ^ k.bits[2];
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+    };
+
+    static uint64_t edgeKey(unsigned int a, unsigned int b) {
+        if (a > b) std::swap(a, b);
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    static Collapse makeCollapse(unsigned int from, unsigned int to, const Vertex* vertices,
+                                 const std::vector<Quadric>& quadrics, const std::vector<unsigned int>& version) {
+        Quadric q = quadrics[from];
+        q.add(quadrics[to]);
+        Collapse c;
+        c.cost = static_cast<float>(std::max(0.0, q.error(vertices[to].Position)));
+        c.from = from;
+        c.to = to;
+        c.fromVersion = version[from];
+        c.toVersion = version[to];
+        return c;
+    }
+
+    static bool flipsTriangle(unsigned int u, unsigned int v, const Vertex* vertices,
+                              const std::vector<unsigned int>& tris, const std::vector<char>& triAlive,
+                              const std::vector<unsigned int>& canonical, const std::vector<unsigned int>& uTris) {
+        const glm::vec3& target = vertices[v].Position;
+        for (unsigned int t : uTris) {
+            if (!triAlive[t]) continue;
+            const unsigned int* tri = &tris[t * 3];
+            glm::vec3 p[3], q[3];
+            bool hasV = false;
+            for (int k = 0; k < 3; k++) {
+                unsigned int c = canonical[tri[k]];
+                hasV |= c == v;
+                p[k] = vertices[tri[k]].Position;
+                q[k] = c == u ? target : p[k];
+            }
+            if (hasV) continue; // ce triangle disparait
+            glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+            glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+            if (glm::dot(before, after) <= 0.0f) return true;
+        }
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,290 @@
+#ifndef MODEL_REGISTRY_H
+#define MODEL_REGISTRY_H
+
+#include <glad.h>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "BVH.h"
+#include "Camera.h"
+#include "GeometryArena.h"
+#include "InstanceData.h"
+#include "JobSystem.h"
+#include "Mesh.h"
+#include "RayQuery.h"
+#include "RenderQueue.h"
+#include "Shader.h"
+#include "VertexQuantizer.h"
+
+typedef uint32_t ModelHandle;
+
+// resultat d'un picking : instance et triangle touches
+struct PickResult {
+    ModelHandle model = 0;
+    size_t instance = 0;      // indice dans Model::instances
+    uint32_t triangle = 0;    // triangle du LOD 0
+    float distance = 0.0f;    // distance le long du rayon (espace monde)
+};
+
+// un maillage dans l'arene de son format et les instances a dessiner cette frame
+struct Model {
+    std::string name;
+    std::unique_ptr<MeshAsset> asset;   // donnees CPU (vue, cache projete ou vecteurs)
+    ArenaRange range;                   // sommets et indices dans l'arene de son format (arenaFor)
+    int textureLayer = 0;               // couche par defaut dans le TextureArray
+    VertexLayout layout = VertexLayout::Float;
+    VertexDecode decode;
+    TriangleBVH bvh;                    // picking exact dans l'espace modele (LOD 0)
+
+    std::vector<InstanceData> instances;                 // soumises pour la frame courante
+    std::vector<std::vector<InstanceData>> lodBuckets;   // instances triees par LOD (reutilise d'une frame a l'autre)
+
+    const MeshView& mesh() const { return asset->view; }
+};
+
+// registre de tous les maillages charges ; les maillages d'un meme format partagent
+// un VBO/EBO et sont dessines ensemble en un glMultiDrawElementsIndirect (une commande par LOD)
+// (format = disposition des sommets + type d'indice)
+class ModelRegistry {
+public:
+    // taille a l'ecran (fraction de la demi-hauteur) sous laquelle on passe au LOD suivant
+    std::vector<float> lodScreenSizes = { 0.5f, 0.25f, 0.1f };
+
+    ModelRegistry()
+        : arenas{ GeometryArena(VertexLayout::Float, GL_UNSIGNED_SHORT), GeometryArena(VertexLayout::Float, GL_UNSIGNED_INT),
+                  GeometryArena(VertexLayout::Packed, GL_UNSIGNED_SHORT), GeometryArena(VertexLayout::Packed, GL_UNSIGNED_INT) } {}
+    ModelRegistry(const ModelRegistry&) = delete;
+    ModelRegistry& operator=(const ModelRegistry&) = delete;
+
+    ~ModelRegistry() { release(); }
+
+    // libere les buffers GL (a appeler tant que le contexte existe encore)
+    void release() {
+        for (GeometryArena& arena : arenas) arena.release();
+        models.clear();
+    }
+
+    // envoie le maillage au GPU (format compresse si l'erreur mesuree reste acceptable)
+    // la BVH de picking se construit sur le job system pendant la compression et l'envoi
+    ModelHandle add(const std::string& name, std::unique_ptr<MeshAsset> asset, int textureLayer = 0,
+                    JobSystem& jobs = JobSystem::instance()) {
+        models.emplace_back();
+        Model& model = models.back();
+        model.name = name;
+        model.asset = std::move(asset);
+        model.textureLayer = textureLayer;
+        const MeshView& mesh = model.mesh();
+
+        JobCounter bvhBuilt;
+        double bvhMs = 0.0;
+        jobs.run([&model, &mesh, &jobs, &bvhMs]() {
+            auto bvhStart = std::chrono::high_resolution_clock::now();
+            model.bvh.build(mesh, 0, 0, jobs);
+            bvhMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - bvhStart).count();
+        }, &bvhBuilt);
+
+        VertexQuantizer quantizer;
+        std::vector<PackedVertex> packed;
+        VertexDecode decode = VertexQuantizer::computeDecode(mesh);
+        VertexQuantizer::pack(mesh, decode, packed);
+        QuantizationError error = VertexQuantizer::measureError(mesh, packed, decode);
+        model.layout = quantizer.chooseLayout(mesh, error);
+        model.decode = model.layout == VertexLayout::Packed ? decode : VertexDecode();
+
+        std::cout << "Modèle " << name << " : format " << (model.layout == VertexLayout::Packed ? "compresse (16 octets)" : "float (32 octets)")
+                  << " | erreur position " << error.position << ", normale " << error.normalDegrees
+                  << " deg, uv " << error.texcoord << std::endl;
+
+        GeometryArena& arena = arenaFor(model.layout, mesh.indexType);
+        if (!arena.initialized()) arena.init();
+        if (model.layout == VertexLayout::Packed)
+            model.range = arena.allocate(packed.data(), packed.size(), mesh);
+        else
+            model.range = arena.allocate(mesh.vertices, mesh.vertexCount, mesh);
+
+        model.lodBuckets.resize(std::max<size_t>(mesh.lodCount, 1));
+
+        jobs.wait(bvhBuilt);
+        std::cout << "BVH " << name << " : " << model.bvh.triangleCount() << " triangles, " << model.bvh.nodeCount() << " noeuds en "
+                  << bvhMs << " ms" << std::endl;
+        return static_cast<ModelHandle>(models.size() - 1);
+    }
+
+    Model& get(ModelHandle handle) { return models[handle]; }
+    const Model& get(ModelHandle handle) const { return models[handle]; }
+    size_t size() const { return models.size(); }
+
+    // a appeler en debut de frame avant de soumettre les instances
+    void clearInstances() {
+        for (Model& model : models) model.instances.clear();
+        instancesChanged = true;
+    }
+
+    // textureLayer < 0 : couche par defaut du modele
+    void addInstance(ModelHandle handle, const glm::mat4& transform, int textureLayer = -1) {
+        Model& model = models[handle];
+        float layer = static_cast<float>(textureLayer < 0 ? model.textureLayer : textureLayer);
+        model.instances.push_back(makeInstance(transform, layer, model.decode));
+        instancesChanged = true;
+    }
+
+    // lance un rayon (espace monde) contre toutes les instances soumises
+    // les boites monde des instances passent par une SceneRayQuery (reconstruite quand les instances
+    // changent) ; seules les instances dont la boite est touchee avant le meilleur resultat sont testees
+    // le rayon passe dans l'espace modele de chaque instance : t y reste le meme qu'en monde
+    bool pick(const glm::vec3& origin, const glm::vec3& direction, PickResult& result) const {
+        if (instancesChanged) buildInstanceQuery();
+        Ray ray;
+        ray.origin = origin;
+        ray.direction = direction;
+        uint32_t triangle = 0;
+        RayResult hit = instanceQuery.castExact(ray, [&](uint32_t object, float& closest) {
+            const InstanceRef& ref = instanceRefs[object];
+            const Model& model = models[ref.model];
+            glm::mat4 inverse = glm::inverse(model.instances[ref.instance].transform);
+            glm::vec3 localOrigin = glm::vec3(inverse * glm::vec4(origin, 1.0f));
+            glm::vec3 localDirection = glm::vec3(inverse * glm::vec4(direction, 0.0f));
+            BVHHit local;
+            if (!model.bvh.intersect(localOrigin, localDirection, local, closest)) return false;
+            closest = local.distance;
+            triangle = local.triangle;
+            return true;
+        });
+        if (hit.object == RayResult::None) return false;
+        result.model = instanceRefs[hit.object].model;
+        result.instance = instanceRefs[hit.object].instance;
+        result.triangle = triangle;
+        result.distance = hit.distance * glm::length(direction);
+        return true;
+    }
+
+    // choisit le LOD selon la taille projetee du modele a l'ecran
+    size_t selectLod(const MeshView& mesh, const glm::mat4& transform, const Camera& camera) const {
+        if (mesh.lodCount <= 1) return 0;
+
+        glm::vec3 center = glm::vec3(transform * glm::vec4((mesh.minBounds + mesh.maxBounds) * 0.5f, 1.0f));
+        float scale = std::max(glm::length(glm::vec3(transform[0])),
+                               std::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+        float radius = glm::length(mesh.maxBounds - mesh.minBounds) * 0.5f * scale;
+        float distance = glm::length(center - camera.Position);
+        if (distance <= radius) return 0; // camera dans la sphere englobante
+
+        // rayon projete en fraction de la demi-hauteur de l'ecran
+        float screenSize = radius / (distance * std::tan(glm::radians(camera.Zoom) * 0.5f));
+        size_t lod = 0;
+        for (float threshold : lodScreenSizes) {
+            if (screenSize < threshold && lod + 1 < mesh.lodCount) lod++;
+        }
+        return lod;
+    }
+
+    // soumet toutes les instances : une commande indirecte par (modele, LOD) visible,
+    // puis un packet par arene (un seul appel de dessin par format de sommet et type d'indice) ;
+    // la texture est le TextureArray commun (pas de changement de texture entre modeles)
+    void submitInstances(RenderQueue& queue, Shader& shader, const DrawUniforms& uniforms, const Camera& camera, GLuint textureArray) {
+        float depths[ArenaCount];
+        for (int i = 0; i < ArenaCount; i++) {
+            depths[i] = std::numeric_limits<float>::max();
+            arenas[i].clearDraws();
+        }
+
+        for (Model& model : models) {
+            if (model.instances.empty()) continue;
+            const MeshView& mesh = model.mesh();
+            const int arenaIndex = indexOf(model.layout, mesh.indexType);
+            GeometryArena& arena = arenas[arenaIndex];
+
+            for (auto& bucket : model.lodBuckets) bucket.clear();
+            for (const InstanceData& instance : model.instances)
+                model.lodBuckets[selectLod(mesh, instance.transform, camera)].push_back(instance);
+
+            // les LOD sans instance ne produisent pas de commande (compaction)
+            for (size_t lod = 0; lod < model.lodBuckets.size(); lod++) {
+                const auto& bucket = model.lodBuckets[lod];
+                size_t indexOffset = 0, indexCount = mesh.indexCount;
+                if (mesh.lodCount > 0) {
+                    indexOffset = mesh.lods[lod].indexOffset;
+                    indexCount = mesh.lods[lod].indexCount;
+                }
+                arena.addDraw(model.range.firstIndex + static_cast<uint32_t>(indexOffset), static_cast<uint32_t>(indexCount),
+                              model.range.baseVertex, bucket.data(), bucket.size());
+            }
+
+            // profondeur de l'arene : instance la plus proche
+            float& depth = depths[arenaIndex];
+            glm::vec3 center = (mesh.minBounds + mesh.maxBounds) * 0.5f;
+            for (const InstanceData& instance : model.instances)
+                depth = std::min(depth, glm::length(glm::vec3(instance.transform * glm::vec4(center, 1.0f)) - camera.Position));
+        }
+
+        for (int i = 0; i < ArenaCount; i++) {
+            if (arenas[i].drawCount() == 0) continue;
+            DrawPacket packet;
+            packet.shader = &shader;
+            packet.uniforms = &uniforms;
+            packet.vao = arenas[i].vao();
+            packet.texture = textureArray;
+            packet.batch = &arenas[i];
+            queue.submit(packet, depths[i]);
+        }
+    }
+
+    const GeometryArena& arena(VertexLayout layout, GLenum indexType) const { return arenas[indexOf(layout, indexType)]; }
+
+private:
+    struct InstanceRef {
+        ModelHandle model;
+        size_t instance;
+    };
+
+    std::vector<Model> models;
+
+    // une arene par (format de sommet, type d'indice) : au plus 4 appels de dessin par frame
+    static const int ArenaCount = 4;
+    GeometryArena arenas[ArenaCount];
+
+    // boites monde des instances soumises, pour pick()
+    mutable SceneRayQuery instanceQuery;
+    mutable std::vector<InstanceRef> instanceRefs;
+    mutable bool instancesChanged = true;
+
+    static int indexOf(VertexLayout layout, GLenum indexType) {
+        return (layout == VertexLayout::Packed ? 2 : 0) + (indexType == GL_UNSIGNED_SHORT ? 0 : 1);
+    }
+    GeometryArena& arenaFor(VertexLayout layout, GLenum indexType) { return arenas[indexOf(layout, indexType)]; }
+
+    void buildInstanceQuery() const {
+        std::vector<glm::vec3> boundsMin, boundsMax;
+        instanceRefs.clear();
+        for (size_t m = 0; m < models.size(); m++) {
+            const Model& model = models[m];
+            if (model.bvh.empty()) continue;
+            const MeshView& mesh = model.mesh();
+            for (size_t i = 0; i < model.instances.size(); i++) {
+                // boite monde : les 8 coins de la boite modele transformes
+                const glm::mat4& transform = model.instances[i].transform;
+                glm::vec3 mn(std::numeric_limits<float>::max()), mx(-std::numeric_limits<float>::max());
+                for (int c = 0; c < 8; c++) {
+                    glm::vec3 corner(c & 1 ? mesh.maxBounds.x : mesh.minBounds.x, c & 2 ? mesh.maxBounds.y : mesh.minBounds.y,
+                                     c & 4 ? mesh.maxBounds.z : mesh.minBounds.z);
+                    glm::vec3 world = glm::vec3(transform * glm::vec4(corner, 1.0f));
+                    mn = glm::min(mn, world);
+                    mx = glm::max(mx, world);
+                }
+                boundsMin.push_back(mn);
+                boundsMax.push_back(mx);
+                instanceRefs.push_back({ static_cast<ModelHandle>(m), i });
+            }
+        }
+        instanceQuery.build(boundsMin, boundsMax);
+        instancesChanged = false;
+    }
+};
+
+#endif
@@ -0,0 +1,275 @@
+#ifndef OBJ_PARSER_H
+#define OBJ_PARSER_H
+
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include "JobSystem.h"
+#include "MappedFile.h"
+
+// coin de face resolu (indices 0-based dans ObjData, -1 = absent)
+struct ObjIndex {
+    int v, t, n;
+};
+
+// donnees brutes d'un .obj, coins tries dans l'ordre du fichier (3 par triangle)
+struct ObjData {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texcoords;
+    std::vector<glm::vec3> normals;
+    std::vector<ObjIndex> corners;
+    size_t faceCount = 0;   // faces du fichier (avant triangulation)
+    size_t bytes = 0;       // taille du fichier lu
+    size_t chunkCount = 0;  // blocs analyses en parallele (1 pour un petit fichier)
+};
+
+// parseur .obj : fichier projete en memoire, decoupe en blocs alignes sur les lignes
+// et analyses en parallele, puis fusionnes dans l'ordre global du fichier
+class ObjParser {
+public:
+    unsigned int threadCount;
+
+    explicit ObjParser(unsigned int threads = 0)
+        : threadCount(threads ? threads : JobSystem::instance().threadCount())
+    {}
+
+    bool parse(const std::string& path, ObjData& out) {
+        MappedFile file;
+        if (!file.open(path)) {
+            std::cerr << "Erreur : Impossible d'ouvrir " << path << std::endl;
+            return false;
+        }
+        out = ObjData();
+        out.bytes = file.size();
+
+        const char* begin = file.data();
+        const char* end = begin + file.size();
+
+        // pas la peine de lancer des threads pour les petits fichiers
+        const size_t minChunkSize = 1 << 20;
+        size_t chunkCount = std::min<size_t>(threadCount, file.size() / minChunkSize + 1);
+        out.chunkCount = chunkCount;
+
+        // bornes des blocs, chaque bloc commence juste apres un '\n'
+        std::vector<const char*> bounds(chunkCount + 1, end);
+        bounds[0] = begin;
+        for (size_t i = 1; i < chunkCount; i++) {
+            const char* p = begin + file.size() * i / chunkCount;
+            p = std::max(p, bounds[i - 1]);
+            const char* nl = p < end ? static_cast<const char*>(std::memchr(p, '\n', end - p)) : nullptr;
+            bounds[i] = nl ? nl + 1 : end;
+        }
+
+        std::vector<Chunk> chunks(chunkCount);
+        runParallel(chunkCount, [&](size_t i) { parseChunk(bounds[i], bounds[i + 1], chunks[i]); });
+
+        for (size_t i = 0; i < chunkCount; i++) {
+            if (!chunks[i].error.empty()) {
+                std::cerr << "Erreur OBJ (" << path << ") : " << chunks[i].error << std::endl;
+                return false;
+            }
+        }
+
+        // prefixes : position de chaque bloc dans les tableaux globaux
+        std::vector<size_t> vBase(chunkCount), tBase(chunkCount), nBase(chunkCount), cBase(chunkCount);
+        size_t vTotal = 0, tTotal = 0, nTotal = 0, cTotal = 0;
+        for (size_t i = 0; i < chunkCount; i++) {
+            vBase[i] = vTotal; vTotal += chunks[i].positions.size();
+            tBase[i] = tTotal; tTotal += chunks[i].texcoords.size();
+            nBase[i] = nTotal; nTotal += chunks[i].normals.size();
+            cBase[i] = cTotal; cTotal += chunks[i].corners.size();
+            out.faceCount += chunks[i].faceCount;
+        }
+        out.positions.resize(vTotal);
+        out.texcoords.resize(tTotal);
+        out.normals.resize(nTotal);
+        out.corners.resize(cTotal);
+
+        // fusion : chaque bloc copie ses donnees et resout ses indices relatifs
+        std::vector<char> badIndex(chunkCount, 0);
+        runParallel(chunkCount, [&](size_t i) {
+            const Chunk& c = chunks[i];
+            std::copy(c.positions.begin(), c.positions.end(), out.positions.begin() + vBase[i]);
+            std::copy(c.texcoords.begin(), c.texcoords.end(), out.texcoords.begin() + tBase[i]);
+            std::copy(c.normals.begin(), c.normals.end(), out.normals.begin() + nBase[i]);
+
+            ObjIndex* dst = out.corners.data() + cBase[i];
+            for (size_t k = 0; k < c.corners.size(); k++) {
+                ObjIndex idx = c.corners[k];
+                uint8_t rel = c.relative[k];
+                if (rel & 1) idx.v += static_cast<int>(vBase[i]);
+                if (rel & 2) idx.t += static_cast<int>(tBase[i]);
+                if (rel & 4) idx.n += static_cast<int>(nBase[i]);
+                uint8_t present = c.present[k];
+                if (idx.v < 0 || idx.v >= static_cast<int>(vTotal) ||
+                    ((present & 2) && (idx.t < 0 || idx.t >= static_cast<int>(tTotal))) ||
+                    ((present & 4) && (idx.n < 0 || idx.n >= static_cast<int>(nTotal)))) {
+                    badIndex[i] = 1;
+                }
+                dst[k] = idx;
+            }
+        });
+
+        if (std::find(badIndex.begin(), badIndex.end(), 1) != badIndex.end()) {
+            std::cerr << "Erreur OBJ (" << path << ") : indice de face hors limites" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    // resultat d'un bloc ; les indices negatifs sont relatifs au debut du bloc
+    struct Chunk {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texcoords;
+        std::vector<glm::vec3> normals;
+        std::vector<ObjIndex> corners;
+        std::vector<uint8_t> relative;  // bit 0/1/2 : v/t/n a decaler par la base du bloc
+        std::vector<uint8_t> present;   // bit 0/1/2 : v/t/n presents dans le fichier
+        std::vector<ObjIndex> polygon;  // tampon reutilise pour les n-gones
+        std::vector<uint8_t> polyRelative;
+        std::vector<uint8_t> polyPresent;
+        size_t faceCount = 0;
+        std::string error;
+    };
+
+    // un bloc par tache du systeme de jobs
+    template <typename Fn>
+    static void runParallel(size_t count, Fn fn) {
+        JobSystem::instance().parallelFor(0, count, 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) fn(i);
+        });
+    }
+
+    static bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    static const char* skipBlanks(const char* p, const char* end) {
+        while (p < end && isBlank(*p)) p++;
+        return p;
+    }
+
+    static const char* parseFloat(const char* p, const char* end, float& value) {
+        p = skipBlanks(p, end);
+        if (p < end && *p == '+') p++; // from_chars refuse le '+'
+        auto res = std::from_chars(p, end, value);
+        if (res.ec != std::errc()) { value = 0.0f; return nullptr; }
+        return res.ptr;
+    }
+
+    static const char* parseInt(const char* p, const char* end, int& value) {
+        if (p < end && *p == '+') p++;
+        auto res = std::from_chars(p, end, value);
+        if (res.ec != std::errc()) return nullptr;
+        return res.ptr;
+    }
+
+    // un coin "v", "v/t", "v//n" ou "v/t/n"
+    static const char* parseCorner(const char* p, const char* end, int* raw, uint8_t& present) {
+        present = 0;
+        p = parseInt(p, end, raw[0]);
+        if (!p) return nullptr;
+        present |= 1;
+        for (int k = 1; k < 3 && p < end && *p == '/'; k++) {
+            p++;
+            if (p < end && *p != '/' && !isBlank(*p) && *p != '\n') {
+                p = parseInt(p, end, raw[k]);
+                if (!p) return nullptr;
+                present |= static_cast<uint8_t>(1 << k);
+            }
+        }
+        return p;
+    }
+
+    static void parseChunk(const char* p, const char* end, Chunk& c) {
+        size_t lineNumber = 0;
+        while (p < end) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!eol) eol = end;
+            lineNumber++;
+
+            const char* q = skipBlanks(p, eol);
+            if (q + 1 < eol && q[0] == 'v' && isBlank(q[1])) {
+                glm::vec3 v(0.0f);
+                const char* r = q + 1;
+                for (int k = 0; k < 3 && r; k++) r = parseFloat(r, eol, v[k]);
+                c.positions.push_back(v);
+            } else if (q + 2 < eol && q[0] == 'v' && q[1] == 't' && isBlank(q[2])) {
+                glm::vec2 t(0.0f);
+                const char* r = parseFloat(q + 2, eol, t.x);
+                if (r) parseFloat(r, eol, t.y); // 'vt u' seul est valide
+                c.texcoords.push_back(t);
+            } else if (q + 2 < eol && q[0] == 'v' && q[1] == 'n' && isBlank(q[2])) {
+                glm::vec3 n(0.0f);
+                const char* r = q + 2;
+                for (int k = 0; k < 3 && r; k++) r = parseFloat(r, eol, n[k]);
+                c.normals.push_back(n);
+            } else if (q + 1 < eol && q[0] == 'f' && isBlank(q[1])) {
+                if (!parseFace(q + 1, eol, c)) {
+                    c.error = "face invalide (ligne " + std::to_string(lineNumber) + " du bloc)";
+                    return;
+                }
+            }
+            p = eol + 1;
+        }
+    }
+
+    static bool parseFace(const char* p, const char* eol, Chunk& c) {
+        c.polygon.clear();
+        c.polyRelative.clear();
+        c.polyPresent.clear();
+
+        const int counts[3] = {
+            static_cast<int>(c.positions.size()),
+            static_cast<int>(c.texcoords.size()),
+            static_cast<int>(c.normals.size())
+        };
+
+        p = skipBlanks(p, eol);
+        while (p < eol) {
+            int raw[3] = { 0, 0, 0 };
+            uint8_t present;
+            p = parseCorner(p, eol, raw, present);
+            if (!p) return false;
+
+            ObjIndex idx = { -1, -1, -1 };
+            uint8_t rel = 0;
+            int* dst[3] = { &idx.v, &idx.t, &idx.n };
+            for (int k = 0; k < 3; k++) {
+                if (!(present & (1 << k))) continue;
+                if (raw[k] > 0) {
+                    *dst[k] = raw[k] - 1;                 // absolu, 1-based
+                } else if (raw[k] < 0) {
+                    *dst[k] = counts[k] + raw[k];         // relatif au dernier element lu
+                    rel |= static_cast<uint8_t>(1 << k);
+                } else {
+                    return false;                         // l'indice 0 n'existe pas en OBJ
+                }
+            }
+            c.polygon.push_back(idx);
+            c.polyRelative.push_back(rel);
+            c.polyPresent.push_back(present);
+            p = skipBlanks(p, eol);
+        }
+
+        if (c.polygon.size() < 3) return false;
+
+        // triangulation en eventail (quads et n-gones convexes)
+        for (size_t k = 1; k + 1 < c.polygon.size(); k++) {
+            const size_t tri[3] = { 0, k, k + 1 };
+            for (size_t j : tri) {
+                c.corners.push_back(c.polygon[j]);
+                c.relative.push_back(c.polyRelative[j]);
+                c.present.push_back(c.polyPresent[j]);
+            }
+        }
+        c.faceCount++;
+        return true;
+    }
+};
+
+#endif
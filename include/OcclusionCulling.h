@@ -0,0 +1,393 @@
+#ifndef OCCLUSION_CULLING_H
+#define OCCLUSION_CULLING_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "JobSystem.h"
+#include "Mesh.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// compteurs de la derniere passe d'occlusion
+struct OcclusionStats {
+    size_t occluderTriangles = 0;   // triangles soumis
+    size_t rasterTriangles = 0;     // apres decoupe au plan proche et rejet hors ecran
+    size_t tested = 0;              // boites testees
+    size_t occluded = 0;            // boites entierement cachees
+    double rasterMs = 0.0;          // transformation, rasterisation et HiZ
+};
+
+// culling d'occlusion logiciel :
+// - les maillages occultants sont rasterises chaque frame dans un petit tampon de profondeur
+//   decoupe en tuiles (une tache par tuile, 4 pixels par iteration en SSE2)
+// - la couverture est erodee d'un texel (max 3x3) puis une pyramide HiZ (profondeur max par bloc)
+//   en est tiree
+// - une boite est cachee si sa profondeur la plus proche est derriere la profondeur
+//   la plus lointaine des occultants sur tout son rectangle a l'ecran
+// profondeur = z NDC ramene dans [0, 1] (0 = plan proche) ; independant d'OpenGL
+class OcclusionCuller {
+public:
+    static const int Width = 256;
+    static const int Height = 192;     // meme rapport 4:3 que la fenetre
+    static const int TileSize = 32;    // multiple de 4 (largeur d'un paquet SSE)
+    static const int TilesX = Width / TileSize;
+    static const int TilesY = Height / TileSize;
+
+    OcclusionCuller() {
+        int w = Width, h = Height;
+        while (true) {
+            levels.push_back(Level{ w, h, std::vector<float>(static_cast<size_t>(w) * h, 1.0f) });
+            if (w == 1 && h == 1) break;
+            w = std::max(1, (w + 1) / 2);
+            h = std::max(1, (h + 1) / 2);
+        }
+        bins.resize(TilesX * TilesY);
+        raster.assign(static_cast<size_t>(Width) * Height, 1.0f);
+        rowMax.assign(static_cast<size_t>(Width) * Height, 1.0f);
+    }
+
+    // ---- occultants ----
+
+    void clearOccluders() { occluders.clear(); }
+
+    // triangles du LOD 0 de mesh places par transform ; mesh doit rester valide jusqu'a render()
+    // (un LOD simplifie peut deborder de la silhouette : il cacherait des objets visibles)
+    void addOccluder(const MeshView& mesh, const glm::mat4& transform) {
+        Occluder occluder;
+        occluder.mesh = &mesh;
+        occluder.transform = transform;
+        occluder.indexCount = mesh.lodCount > 0 ? mesh.lods[0].indexCount : mesh.indexCount;
+        occluder.firstTriangle = triangleTotal();
+        occluders.push_back(occluder);
+    }
+
+    size_t occluderCount() const { return occluders.size(); }
+
+    // rasterise tous les occultants avec la projection * vue de la frame puis construit la HiZ
+    void render(const glm::mat4& viewProjection, JobSystem& jobs = JobSystem::instance()) {
+        auto start = std::chrono::high_resolution_clock::now();
+        stats = OcclusionStats();
+        const size_t triangles = triangleTotal();
+        stats.occluderTriangles = triangles;
+        lastViewProjection = viewProjection;
+
+        // 1. transformation et decoupe au plan proche : 2 triangles ecran au plus par triangle
+        screen.resize(triangles * 2);
+        jobs.parallelFor(0, triangles, [&](size_t begin, size_t end) { setupRange(viewProjection, begin, end); }, 256);
+
+        // 2. repartition dans les tuiles (sequentiel : peu de triangles a basse resolution)
+        for (auto& bin : bins) bin.clear();
+        for (uint32_t t = 0; t < screen.size(); t++) {
+            const ScreenTriangle& tri = screen[t];
+            if (!tri.valid) continue;
+            stats.rasterTriangles++;
+            for (int ty = tri.minY / TileSize; ty <= tri.maxY / TileSize; ty++)
+                for (int tx = tri.minX / TileSize; tx <= tri.maxX / TileSize; tx++)
+                    bins[ty * TilesX + tx].push_back(t);
+        }
+
+        // 3. une tache par tuile : aucune ecriture partagee entre taches
+        jobs.parallelFor(0, bins.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t tile = begin; tile < end; tile++) rasterTile(static_cast<int>(tile));
+        });
+
+        // 4. erosion : la profondeur n'est echantillonnee qu'au centre des texels, un texel de la
+        //    silhouette peut n'etre couvert qu'en partie ; chaque texel prend la profondeur la plus
+        //    lointaine de ses 8 voisins, donc un texel n'est plein que si ses voisins le sont aussi
+        erode();
+
+        // 5. pyramide : chaque texel garde la profondeur la plus lointaine de ses 4 enfants
+        for (size_t l = 1; l < levels.size(); l++) downsample(levels[l - 1], levels[l]);
+
+        stats.rasterMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    // ---- tests (apres render, lecture seule : appelable depuis plusieurs threads) ----
+
+    bool visible(const glm::vec3& boxMin, const glm::vec3& boxMax) const {
+        float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, nearest = 1.0f;
+        for (int c = 0; c < 8; c++) {
+            glm::vec4 clip = lastViewProjection * glm::vec4(c & 1 ? boxMax.x : boxMin.x, c & 2 ? boxMax.y : boxMin.y,
+                                                            c & 4 ? boxMax.z : boxMin.z, 1.0f);
+            if (clip.z < -clip.w || clip.w <= 0.0f) return true; // coupe le plan proche : on ne conclut pas
+            float invW = 1.0f / clip.w;
+            float x = (clip.x * invW * 0.5f + 0.5f) * Width;
+            float y = (clip.y * invW * 0.5f + 0.5f) * Height;
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+            nearest = std::min(nearest, clip.z * invW * 0.5f + 0.5f);
+        }
+
+        // pixels dont le centre tombe dans le rectangle (hors ecran : le frustum s'en charge)
+        int x0 = std::max(0, static_cast<int>(std::floor(minX))), x1 = std::min(Width - 1, static_cast<int>(std::ceil(maxX)));
+        int y0 = std::max(0, static_cast<int>(std::floor(minY))), y1 = std::min(Height - 1, static_cast<int>(std::ceil(maxY)));
+        if (x0 > x1 || y0 > y1) return true;
+
+        // niveau ou le rectangle couvre au plus 4 texels par axe
+        size_t level = 0;
+        while (level + 1 < levels.size() && std::max(x1 - x0, y1 - y0) >> level > 3) level++;
+        const Level& hiz = levels[level];
+        int lx0 = x0 >> level, lx1 = std::min(hiz.width - 1, x1 >> level);
+        int ly0 = y0 >> level, ly1 = std::min(hiz.height - 1, y1 >> level);
+        for (int y = ly0; y <= ly1; y++)
+            for (int x = lx0; x <= lx1; x++)
+                if (hiz.depth[static_cast<size_t>(y) * hiz.width + x] >= nearest) return true;
+        return false;
+    }
+
+    // teste les boites encore visibles (visibility != 0, par ex. apres le frustum) ; renvoie le nb de cachees
+    size_t cull(const glm::vec3* boxMin, const glm::vec3* boxMax, size_t count, uint8_t* visibility,
+                JobSystem& jobs = JobSystem::instance()) {
+        // compteurs par tranche reutilises d'un appel a l'autre (pas d'allocation une fois dimensionnes)
+        occludedPerChunk.assign((count + CullGrain - 1) / CullGrain, 0);
+        testedPerChunk.assign(occludedPerChunk.size(), 0);
+        jobs.parallelFor(0, count, CullGrain, [&](size_t begin, size_t end) {
+            size_t chunk = begin / CullGrain;
+            for (size_t i = begin; i < end; i++) {
+                if (!visibility[i]) continue;
+                testedPerChunk[chunk]++;
+                if (!visible(boxMin[i], boxMax[i])) {
+                    visibility[i] = 0;
+                    occludedPerChunk[chunk]++;
+                }
+            }
+        });
+        size_t occluded = 0;
+        for (size_t c = 0; c < occludedPerChunk.size(); c++) {
+            occluded += occludedPerChunk[c];
+            stats.tested += testedPerChunk[c];
+        }
+        stats.occluded += occluded;
+        return occluded;
+    }
+
+    // a appeler pour chaque boite testee avec visible() (compteurs seulement)
+    void count(bool occluded) {
+        stats.tested++;
+        stats.occluded += occluded ? 1 : 0;
+    }
+
+    // profondeur d'un texel de la pyramide (niveau 0 = tampon rasterise puis erode)
+    float depth(int x, int y, size_t level = 0) const {
+        const Level& l = levels[level];
+        return l.depth[static_cast<size_t>(y) * l.width + x];
+    }
+
+    size_t levelCount() const { return levels.size(); }
+    const OcclusionStats& statistics() const { return stats; }
+
+private:
+    static const size_t CullGrain = 1024;   // boites par tache
+
+    struct Occluder {
+        const MeshView* mesh;
+        glm::mat4 transform;
+        size_t indexCount;
+        size_t firstTriangle;   // indice global du premier triangle
+    };
+
+    struct Level {
+        int width, height;
+        std::vector<float> depth;
+    };
+
+    // triangle ecran pret a rasteriser (sens direct, pixels [min, max] inclus)
+    struct ScreenTriangle {
+        float x[3], y[3];
+        float z0, dzdx, dzdy;   // plan de profondeur a partir du sommet 0
+        int minX, minY, maxX, maxY;
+        bool valid;
+    };
+
+    std::vector<Occluder> occluders;
+    std::vector<ScreenTriangle> screen;
+    std::vector<std::vector<uint32_t>> bins;   // triangles par tuile
+    std::vector<float> raster, rowMax;         // tampon rasterise, max horizontal (erosion)
+    std::vector<size_t> occludedPerChunk, testedPerChunk;   // cull()
+    std::vector<Level> levels;                 // levels[0] = tampon erode
+    glm::mat4 lastViewProjection = glm::mat4(1.0f);
+    OcclusionStats stats;
+
+    size_t triangleTotal() const {
+        return occluders.empty() ? 0 : occluders.back().firstTriangle + occluders.back().indexCount / 3;
+    }
+
+    void setupRange(const glm::mat4& viewProjection, size_t begin, size_t end) {
+        size_t o = 0;
+        for (size_t t = begin; t < end; t++) {
+            while (t >= occluders[o].firstTriangle + occluders[o].indexCount / 3) o++;
+            const Occluder& occluder = occluders[o];
+            const MeshView& mesh = *occluder.mesh;
+            size_t first = (t - occluder.firstTriangle) * 3;
+
+            glm::vec4 clip[3];
+            for (int k = 0; k < 3; k++) {
+                const glm::vec3& p = mesh.vertices[mesh.index(first + k)].Position;
+                clip[k] = viewProjection * (occluder.transform * glm::vec4(p, 1.0f));
+            }
+            ScreenTriangle& a = screen[t * 2];
+            ScreenTriangle& b = screen[t * 2 + 1];
+            a.valid = b.valid = false;
+
+            // decoupe au plan proche (z + w >= 0) : 0, 3 ou 4 sommets
+            glm::vec4 poly[4];
+            int n = 0;
+            for (int k = 0; k < 3; k++) {
+                const glm::vec4& p = clip[k];
+                const glm::vec4& q = clip[(k + 1) % 3];
+                float dp = p.z + p.w, dq = q.z + q.w;
+                if (dp >= 0.0f) poly[n++] = p;
+                if ((dp >= 0.0f) != (dq >= 0.0f)) poly[n++] = p + (q - p) * (dp / (dp - dq));
+            }
+            if (n < 3) continue;
+            setupTriangle(poly[0], poly[1], poly[2], a);
+            if (n == 4) setupTriangle(poly[0], poly[2], poly[3], b);
+        }
+    }
+
+    static void setupTriangle(const glm::vec4& c0, const glm::vec4& c1, const glm::vec4& c2, ScreenTriangle& tri) {
+        const glm::vec4* c[3] = { &c0, &c1, &c2 };
+        float z[3];
+        for (int k = 0; k < 3; k++) {
+            float w = std::max(c[k]->w, 1e-6f);
+            tri.x[k] = (c[k]->x / w * 0.5f + 0.5f) * Width;
+            tri.y[k] = (c[k]->y / w * 0.5f + 0.5f) * Height;
+            z[k] = c[k]->z / w * 0.5f + 0.5f;
+        }
+        float area = (tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) - (tri.x[2] - tri.x[0]) * (tri.y[1] - tri.y[0]);
+        if (!(std::fabs(area) > 1e-8f)) return; // degenere (ou NaN)
+        // occultants a double face : on remet le triangle dans le sens direct
+        if (area < 0.0f) {
+            std::swap(tri.x[1], tri.x[2]);
+            std::swap(tri.y[1], tri.y[2]);
+            std::swap(z[1], z[2]);
+            area = -area;
+        }
+
+        float bx0 = std::min(tri.x[0], std::min(tri.x[1], tri.x[2])), bx1 = std::max(tri.x[0], std::max(tri.x[1], tri.x[2]));
+        float by0 = std::min(tri.y[0], std::min(tri.y[1], tri.y[2])), by1 = std::max(tri.y[0], std::max(tri.y[1], tri.y[2]));
+        if (bx1 < 0.0f || by1 < 0.0f || bx0 >= Width || by0 >= Height) return;
+        tri.minX = std::max(0, static_cast<int>(bx0));
+        tri.minY = std::max(0, static_cast<int>(by0));
+        tri.maxX = std::min(Width - 1, static_cast<int>(bx1));
+        tri.maxY = std::min(Height - 1, static_cast<int>(by1));
+
+        tri.dzdx = ((z[1] - z[0]) * (tri.y[2] - tri.y[0]) - (z[2] - z[0]) * (tri.y[1] - tri.y[0])) / area;
+        tri.dzdy = ((tri.x[1] - tri.x[0]) * (z[2] - z[0]) - (tri.x[2] - tri.x[0]) * (z[1] - z[0])) / area;
+        tri.z0 = z[0];
+        tri.valid = true;
+    }
+
+    void rasterTile(int tile) {
+        const int tileX0 = (tile % TilesX) * TileSize, tileY0 = (tile / TilesX) * TileSize;
+        float* depth = raster.data();
+        for (int y = tileY0; y < tileY0 + TileSize; y++)
+            std::fill(depth + static_cast<size_t>(y) * Width + tileX0, depth + static_cast<size_t>(y) * Width + tileX0 + TileSize, 1.0f);
+
+        for (uint32_t index : bins[tile]) {
+            const ScreenTriangle& tri = screen[index];
+            int x0 = std::max(tri.minX, tileX0) & ~3, x1 = std::min(tri.maxX, tileX0 + TileSize - 1);
+            int y0 = std::max(tri.minY, tileY0), y1 = std::min(tri.maxY, tileY0 + TileSize - 1);
+
+            // aretes a -> b : E(p) = A * px + B * py + C, positive a l'interieur
+            // calculees dans un ordre canonique des extremites puis negees : une arete partagee donne
+            // exactement -E a l'autre triangle, donc pas de trou le long de la diagonale d'un quad
+            float A[3], B[3], C[3];
+            for (int e = 0; e < 3; e++) {
+                int a = e, b = (e + 1) % 3;
+                bool flip = tri.x[a] > tri.x[b] || (tri.x[a] == tri.x[b] && tri.y[a] > tri.y[b]);
+                if (flip) std::swap(a, b);
+                A[e] = -(tri.y[b] - tri.y[a]);
+                B[e] = tri.x[b] - tri.x[a];
+                C[e] = (tri.y[b] - tri.y[a]) * tri.x[a] - (tri.x[b] - tri.x[a]) * tri.y[a];
+                if (flip) {
+                    A[e] = -A[e];
+                    B[e] = -B[e];
+                    C[e] = -C[e];
+                }
+            }
+            // profondeur au centre du pixel (x, y) : zC + dzdx * x + dzdy * y
+            float zC = tri.z0 - tri.dzdx * tri.x[0] - tri.dzdy * tri.y[0];
+
+            for (int y = y0; y <= y1; y++) {
+                float py = y + 0.5f;
+                float* row = depth + static_cast<size_t>(y) * Width;
+                int x = x0;
+#if defined(__SSE2__) || defined(_M_X64)
+                const __m128 lane = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+                __m128 rowE[3], stepA[3];
+                for (int e = 0; e < 3; e++) {
+                    rowE[e] = _mm_set1_ps(B[e] * py + C[e]);
+                    stepA[e] = _mm_set1_ps(A[e]);
+                }
+                const __m128 rowZ = _mm_set1_ps(zC + tri.dzdy * py), dzdx = _mm_set1_ps(tri.dzdx);
+                const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+                for (; x <= x1; x += 4) {
+                    __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lane);
+                    __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(stepA[0], px), rowE[0]), zero);
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(stepA[1], px), rowE[1]), zero));
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(stepA[2], px), rowE[2]), zero));
+                    if (_mm_movemask_ps(inside) == 0) continue;
+                    // profondeur bornee a [0, 1] : un occultant au-dela du plan lointain ne cache rien de plus
+                    __m128 z = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(dzdx, px), rowZ), zero), one);
+                    __m128 current = _mm_loadu_ps(row + x);
+                    __m128 nearer = _mm_min_ps(current, z);
+                    _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, current)));
+                }
+#else
+                for (; x <= x1; x++) {
+                    float px = x + 0.5f;
+                    if (A[0] * px + B[0] * py + C[0] < 0.0f || A[1] * px + B[1] * py + C[1] < 0.0f ||
+                        A[2] * px + B[2] * py + C[2] < 0.0f)
+                        continue;
+                    float z = std::min(std::max(zC + tri.dzdx * px + tri.dzdy * py, 0.0f), 1.0f);
+                    row[x] = std::min(row[x], z);
+                }
+#endif
+            }
+        }
+    }
+
+    // max 3x3 separable de raster vers levels[0] (bords : voisins hors ecran ignores)
+    void erode() {
+        for (int y = 0; y < Height; y++) {
+            const float* in = &raster[static_cast<size_t>(y) * Width];
+            float* out = &rowMax[static_cast<size_t>(y) * Width];
+            out[0] = std::max(in[0], in[1]);
+            for (int x = 1; x < Width - 1; x++) out[x] = std::max(in[x - 1], std::max(in[x], in[x + 1]));
+            out[Width - 1] = std::max(in[Width - 2], in[Width - 1]);
+        }
+        float* depth = levels[0].depth.data();
+        for (int y = 0; y < Height; y++) {
+            const float* up = &rowMax[static_cast<size_t>(std::max(0, y - 1)) * Width];
+            const float* mid = &rowMax[static_cast<size_t>(y) * Width];
+            const float* down = &rowMax[static_cast<size_t>(std::min(Height - 1, y + 1)) * Width];
+            float* out = depth + static_cast<size_t>(y) * Width;
+            for (int x = 0; x < Width; x++) out[x] = std::max(up[x], std::max(mid[x], down[x]));
+        }
+    }
+
+    static void downsample(const Level& src, Level& dst) {
+        for (int y = 0; y < dst.height; y++) {
+            int sy0 = std::min(src.height - 1, y * 2), sy1 = std::min(src.height - 1, y * 2 + 1);
+            const float* r0 = &src.depth[static_cast<size_t>(sy0) * src.width];
+            const float* r1 = &src.depth[static_cast<size_t>(sy1) * src.width];
+            float* out = &dst.depth[static_cast<size_t>(y) * dst.width];
+            for (int x = 0; x < dst.width; x++) {
+                int sx0 = std::min(src.width - 1, x * 2), sx1 = std::min(src.width - 1, x * 2 + 1);
+                out[x] = std::max(std::max(r0[sx0], r0[sx1]), std::max(r1[sx0], r1[sx1]));
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef PHYSICS_THREAD_H
+#define PHYSICS_THREAD_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+#include "PhysicsWorld.h"
+
+// triple buffer sans verrou : un seul ecrivain, un seul lecteur
+// l'ecrivain remplit writeBuffer() puis publish(), le lecteur appelle update() puis readBuffer()
+// aucun des deux n'attend l'autre : le lecteur voit toujours le dernier etat publie complet
+template <typename T>
+class TripleBuffer {
+public:
+    T& writeBuffer() { return slots[back]; }
+
+    void publish() {
+        back = middle.exchange(static_cast<uint8_t>(back | DirtyBit), std::memory_order_acq_rel) & IndexMask;
+    }
+
+    // renvoie vrai si un nouvel etat a ete recupere
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & DirtyBit)) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & IndexMask;
+        return true;
+    }
+
+    const T& readBuffer() const { return slots[front]; }
+
+private:
+    static const uint8_t IndexMask = 0x3;
+    static const uint8_t DirtyBit = 0x4;
+
+    T slots[3];
+    std::atomic<uint8_t> middle{ 1 };
+    uint8_t back = 0;    // propre a l'ecrivain
+    uint8_t front = 2;   // propre au lecteur
+};
+
+// copie des positions et boites de tous les corps a un tick donne
+struct PhysicsState {
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+
+    void capture(const PhysicsWorld& world) {
+        const size_t n = world.size();
+        posX.assign(world.positionsX(), world.positionsX() + n);
+        posY.assign(world.positionsY(), world.positionsY() + n);
+        posZ.assign(world.positionsZ(), world.positionsZ() + n);
+        minX.assign(world.boundsMinX(), world.boundsMinX() + n);
+        minY.assign(world.boundsMinY(), world.boundsMinY() + n);
+        minZ.assign(world.boundsMinZ(), world.boundsMinZ() + n);
+        maxX.assign(world.boundsMaxX(), world.boundsMaxX() + n);
+        maxY.assign(world.boundsMaxY(), world.boundsMaxY() + n);
+        maxZ.assign(world.boundsMaxZ(), world.boundsMaxZ() + n);
+    }
+
+    size_t size() const { return posX.size(); }
+};
+
+// ce que voit le rendu : les deux derniers ticks, a interpoler
+struct PhysicsFrame {
+    PhysicsState previous, current;
+    double publishTime = 0.0;   // instant (horloge PhysicsThread::now) ou current a ete publie
+    uint64_t tick = 0;
+
+    size_t size() const { return current.size(); }
+
+    glm::vec3 position(BodyId id, float alpha) const {
+        return lerp(previous.posX, previous.posY, previous.posZ, current.posX, current.posY, current.posZ, id, alpha);
+    }
+    glm::vec3 minBounds(BodyId id, float alpha) const {
+        return lerp(previous.minX, previous.minY, previous.minZ, current.minX, current.minY, current.minZ, id, alpha);
+    }
+    glm::vec3 maxBounds(BodyId id, float alpha) const {
+        return lerp(previous.maxX, previous.maxY, previous.maxZ, current.maxX, current.maxY, current.maxZ, id, alpha);
+    }
+
+private:
+    static glm::vec3 lerp(const std::vector<float>& ax, const std::vector<float>& ay, const std::vector<float>& az,
+                          const std::vector<float>& bx, const std::vector<float>& by, const std::vector<float>& bz,
+                          BodyId id, float alpha) {
+        // seuls les corps presents aux deux ticks sont interpoles ; un corps apparu a ce tick
+        // est copie tel quel, un id au-dela du tick courant renvoie sa derniere position connue
+        if (id >= bx.size()) return id < ax.size() ? glm::vec3(ax[id], ay[id], az[id]) : glm::vec3(0.0f);
+        if (id >= ax.size()) return glm::vec3(bx[id], by[id], bz[id]);
+        return glm::mix(glm::vec3(ax[id], ay[id], az[id]), glm::vec3(bx[id], by[id], bz[id]), alpha);
+    }
+};
+
+// fait tourner la physique a pas fixe sur son propre thread (accumulateur)
+// le rendu lit les etats publies sans verrou et interpole entre les deux derniers ticks
+// le monde ne doit plus etre modifie par un autre thread entre start() et stop()
+class PhysicsThread {
+public:
+    typedef std::function<void(float)> TickFunction;
+
+    PhysicsThread(const PhysicsWorld& world, TickFunction tick, float tickRate = 60.0f)
+        : world(world), tick(tick), fixedStep(1.0f / tickRate) {}
+
+    ~PhysicsThread() { stop(); }
+
+    PhysicsThread(const PhysicsThread&) = delete;
+    PhysicsThread& operator=(const PhysicsThread&) = delete;
+
+    float step() const { return fixedStep; }
+
+    // nombre max de ticks rattrapes d'un coup (evite la spirale quand un tick coute trop cher)
+    int maxCatchUpTicks = 5;
+
+    void start() {
+        if (running.exchange(true)) return;
+        // etat initial publie avant le premier tick
+        current.capture(world);
+        previous = current;
+        publish(now(), 0);
+        worker = std::thread(&PhysicsThread::run, this);
+    }
+
+    // sans thread (rejeu reproductible) : count ticks executes sur l'appelant puis publies
+    // a utiliser a la place de start(), avec alpha = 1
+    void advance(int count) {
+        if (running.load(std::memory_order_relaxed)) return;
+        if (!synchronousStarted) {
+            current.capture(world);
+            synchronousStarted = true;
+        }
+        uint64_t tickIndex = ticks.load(std::memory_order_relaxed);
+        for (int i = 0; i < count; i++) stepOnce(tickIndex);
+        publish(now(), tickIndex);
+        ticks.store(tickIndex, std::memory_order_relaxed);
+    }
+
+    void stop() {
+        if (!running.exchange(false)) return;
+        if (worker.joinable()) worker.join();
+    }
+
+    // a appeler par le rendu une fois par frame : dernier etat publie
+    const PhysicsFrame& acquire() {
+        buffers.update();
+        return buffers.readBuffer();
+    }
+
+    // facteur d'interpolation entre previous et current pour l'instant "time"
+    // (un tick de retard : on arrive sur current au moment ou le tick suivant est publie)
+    float alpha(const PhysicsFrame& frame, double time) const {
+        return std::min(1.0f, std::max(0.0f, static_cast<float>((time - frame.publishTime) / fixedStep)));
+    }
+
+    double lastTickMs() const { return tickMs.load(std::memory_order_relaxed); }
+    uint64_t tickCount() const { return ticks.load(std::memory_order_relaxed); }
+
+    static double now() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    const PhysicsWorld& world;
+    TickFunction tick;
+    float fixedStep;
+
+    std::thread worker;
+    std::atomic<bool> running{ false };
+    std::atomic<double> tickMs{ 0.0 };
+    std::atomic<uint64_t> ticks{ 0 };
+
+    PhysicsState previous, current;      // propres au thread physique
+    bool synchronousStarted = false;     // advance() a deja capture l'etat initial
+    TripleBuffer<PhysicsFrame> buffers;
+
+    void publish(double time, uint64_t tickIndex) {
+        PhysicsFrame& frame = buffers.writeBuffer();
+        frame.previous = previous;
+        frame.current = current;
+        frame.publishTime = time;
+        frame.tick = tickIndex;
+        buffers.publish();
+    }
+
+    void stepOnce(uint64_t& tickIndex) {
+        auto start = std::chrono::steady_clock::now();
+        std::swap(previous, current);
+        tick(fixedStep);
+        current.capture(world);
+        tickIndex++;
+        tickMs.store(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(),
+                     std::memory_order_relaxed);
+    }
+
+    void run() {
+        double last = now();
+        double accumulator = 0.0;
+        uint64_t tickIndex = 0;
+
+        while (running.load(std::memory_order_relaxed)) {
+            double time = now();
+            accumulator += time - last;
+            last = time;
+            accumulator = std::min(accumulator, static_cast<double>(fixedStep) * maxCatchUpTicks);
+
+            bool stepped = false;
+            while (accumulator >= fixedStep) {
+                stepOnce(tickIndex);
+                accumulator -= fixedStep;
+                stepped = true;
+            }
+            if (stepped) {
+                publish(now(), tickIndex);
+                ticks.store(tickIndex, std::memory_order_relaxed);
+            }
+
+            // dort jusqu'au prochain tick
+            double wait = fixedStep - accumulator - (now() - last);
+            if (wait > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef PHYSICS_WORLD_H
+#define PHYSICS_WORLD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "JobSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PHYSICS_WORLD_SSE 1
+#endif
+
+typedef uint32_t BodyId;
+
+// paire de corps dont les boites se chevauchent (a < b)
+struct BodyPair {
+    BodyId a, b;
+};
+
+// tous les corps en structure de tableaux : une composante par tableau,
+// integres par paquets de 4 (SSE) puis en scalaire pour le reste
+// independant d'OpenGL : utilisable sans contexte (benchmark, thread physique)
+class PhysicsWorld {
+public:
+    float groundHeight = -2.0f;   // hauteur du sol (plan infini)
+    float maxFallSpeed = 5.0f;    // vitesse de chute max
+    float timeScale = 0.5f;       // facteur de ralentissement (0.5 = deux fois plus lent)
+    float restSpeed = 0.1f;       // sous cette vitesse apres rebond on arrete le corps
+
+    void reserve(size_t count) {
+        for (auto* array : arrays()) array->reserve(count);
+    }
+
+    void clear() {
+        for (auto* array : arrays()) array->clear();
+    }
+
+    // scale = taille de la boite englobante (comme l'echelle de l'ancien PhysicsObject)
+    BodyId addBody(const glm::vec3& position, const glm::vec3& scale, float restitution = 0.8f,
+                   bool isStatic = false, const glm::vec3& acceleration = glm::vec3(0.0f, -2.5f, 0.0f)) {
+        glm::vec3 half = scale * 0.5f;
+        posX.push_back(position.x); posY.push_back(position.y); posZ.push_back(position.z);
+        velX.push_back(0.0f); velY.push_back(0.0f); velZ.push_back(0.0f);
+        accX.push_back(acceleration.x); accY.push_back(acceleration.y); accZ.push_back(acceleration.z);
+        halfX.push_back(half.x); halfY.push_back(half.y); halfZ.push_back(half.z);
+        minX.push_back(position.x - half.x); minY.push_back(position.y - half.y); minZ.push_back(position.z - half.z);
+        maxX.push_back(position.x + half.x); maxY.push_back(position.y + half.y); maxZ.push_back(position.z + half.z);
+        bounce.push_back(restitution);
+        motion.push_back(isStatic ? 0.0f : 1.0f);
+        return static_cast<BodyId>(posX.size() - 1);
+    }
+
+    size_t size() const { return posX.size(); }
+
+    glm::vec3 position(BodyId id) const { return glm::vec3(posX[id], posY[id], posZ[id]); }
+    glm::vec3 velocity(BodyId id) const { return glm::vec3(velX[id], velY[id], velZ[id]); }
+    glm::vec3 minBounds(BodyId id) const { return glm::vec3(minX[id], minY[id], minZ[id]); }
+    glm::vec3 maxBounds(BodyId id) const { return glm::vec3(maxX[id], maxY[id], maxZ[id]); }
+    float restitution(BodyId id) const { return bounce[id]; }
+    bool isStatic(BodyId id) const { return motion[id] == 0.0f; }
+
+    void setPosition(BodyId id, const glm::vec3& p) {
+        posX[id] = p.x; posY[id] = p.y; posZ[id] = p.z;
+        updateBounds(id, id + 1);
+    }
+    void setVelocity(BodyId id, const glm::vec3& v) { velX[id] = v.x; velY[id] = v.y; velZ[id] = v.z; }
+    void setRestitution(BodyId id, float r) { bounce[id] = r; }
+
+    // acces direct aux tableaux (culling, broadphase, copie vers le rendu)
+    const float* positionsX() const { return posX.data(); }
+    const float* positionsY() const { return posY.data(); }
+    const float* positionsZ() const { return posZ.data(); }
+    const float* velocitiesX() const { return velX.data(); }
+    const float* velocitiesY() const { return velY.data(); }
+    const float* velocitiesZ() const { return velZ.data(); }
+    const float* boundsMinX() const { return minX.data(); }
+    const float* boundsMinY() const { return minY.data(); }
+    const float* boundsMinZ() const { return minZ.data(); }
+    const float* boundsMaxX() const { return maxX.data(); }
+    const float* boundsMaxY() const { return maxY.data(); }
+    const float* boundsMaxZ() const { return maxZ.data(); }
+
+    static const size_t StepGrain = 16384;   // corps par tache (multiple de 4)
+
+    // integre tous les corps : vitesse, limite de chute, position, contact avec le sol
+    // les tranches de corps sont independantes et reparties sur le systeme de jobs
+    void step(float deltaTime, JobSystem& jobs = JobSystem::instance()) {
+        const float dt = deltaTime * timeScale;
+        jobs.parallelFor(0, size(), StepGrain, [&](size_t begin, size_t end) { stepRange(dt, begin, end); });
+    }
+
+    // reponse aux collisions entre corps : separation sur l'axe de moindre penetration
+    // puis impulsion avec le plus petit des deux coefs de rebond (masses egales)
+    // renvoie le nombre de paires qui se touchaient vraiment
+    size_t resolveContacts(const std::vector<BodyPair>& pairs) {
+        size_t contacts = 0;
+        for (const BodyPair& pair : pairs) {
+            const BodyId a = pair.a, b = pair.b;
+            const float ma = motion[a], mb = motion[b];
+            if (ma + mb == 0.0f) continue; // deux corps statiques
+
+            float overlap[3] = {
+                std::min(maxX[a], maxX[b]) - std::max(minX[a], minX[b]),
+                std::min(maxY[a], maxY[b]) - std::max(minY[a], minY[b]),
+                std::min(maxZ[a], maxZ[b]) - std::max(minZ[a], minZ[b])
+            };
+            if (overlap[0] <= 0.0f || overlap[1] <= 0.0f || overlap[2] <= 0.0f) continue;
+            contacts++;
+
+            int axis = 0;
+            if (overlap[1] < overlap[axis]) axis = 1;
+            if (overlap[2] < overlap[axis]) axis = 2;
+
+            std::vector<float>* pos[3] = { &posX, &posY, &posZ };
+            std::vector<float>* vel[3] = { &velX, &velY, &velZ };
+            std::vector<float>& p = *pos[axis];
+            std::vector<float>& v = *vel[axis];
+
+            // normale de a vers b sur l'axe choisi
+            float n = p[b] >= p[a] ? 1.0f : -1.0f;
+
+            // separation repartie selon la mobilite de chaque corps
+            float push = overlap[axis] / (ma + mb);
+            p[a] -= n * push * ma;
+            p[b] += n * push * mb;
+            updateBounds(a, a + 1);
+            updateBounds(b, b + 1);
+
+            float approach = (v[b] - v[a]) * n;
+            if (approach >= 0.0f) continue; // deja en train de se separer
+            float e = std::min(bounce[a], bounce[b]);
+            float j = -(1.0f + e) * approach / (ma + mb);
+            v[a] -= n * j * ma;
+            v[b] += n * j * mb;
+        }
+        return contacts;
+    }
+
+private:
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> velX, velY, velZ;
+    std::vector<float> accX, accY, accZ;
+    std::vector<float> halfX, halfY, halfZ;
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+    std::vector<float> bounce;   // coef de restitution
+    std::vector<float> motion;   // 1 = dynamique, 0 = statique
+
+    std::vector<std::vector<float>*> arrays() {
+        return { &posX, &posY, &posZ, &velX, &velY, &velZ, &accX, &accY, &accZ,
+                 &halfX, &halfY, &halfZ, &minX, &minY, &minZ, &maxX, &maxY, &maxZ, &bounce, &motion };
+    }
+
+    // integration d'une tranche [begin, end) : 4 corps par iteration puis le reste en scalaire
+    void stepRange(float dt, size_t begin, size_t end) {
+        size_t i = begin;
+#ifdef PHYSICS_WORLD_SSE
+        const __m128 dt4 = _mm_set1_ps(dt);
+        const __m128 maxFall4 = _mm_set1_ps(-maxFallSpeed);
+        const __m128 ground4 = _mm_set1_ps(groundHeight);
+        const __m128 rest4 = _mm_set1_ps(restSpeed);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000u)));
+        for (; i + 4 <= end; i += 4) {
+            // les corps statiques ont motion = 0 : ni vitesse ni deplacement
+            __m128 m = _mm_mul_ps(dt4, _mm_loadu_ps(&motion[i]));
+
+            __m128 vx = _mm_add_ps(_mm_loadu_ps(&velX[i]), _mm_mul_ps(_mm_loadu_ps(&accX[i]), m));
+            __m128 vy = _mm_add_ps(_mm_loadu_ps(&velY[i]), _mm_mul_ps(_mm_loadu_ps(&accY[i]), m));
+            __m128 vz = _mm_add_ps(_mm_loadu_ps(&velZ[i]), _mm_mul_ps(_mm_loadu_ps(&accZ[i]), m));
+            vy = _mm_max_ps(vy, maxFall4);
+
+            __m128 px = _mm_add_ps(_mm_loadu_ps(&posX[i]), _mm_mul_ps(vx, m));
+            __m128 py = _mm_add_ps(_mm_loadu_ps(&posY[i]), _mm_mul_ps(vy, m));
+            __m128 pz = _mm_add_ps(_mm_loadu_ps(&posZ[i]), _mm_mul_ps(vz, m));
+
+            // contact : on replace sur le sol et on inverse la vitesse avec le coef de rebond
+            __m128 hy = _mm_loadu_ps(&halfY[i]);
+            __m128 hit = _mm_and_ps(_mm_cmple_ps(_mm_sub_ps(py, hy), ground4), _mm_cmpgt_ps(m, _mm_setzero_ps()));
+            __m128 bounced = _mm_xor_ps(_mm_mul_ps(vy, _mm_loadu_ps(&bounce[i])), signMask);
+            bounced = _mm_andnot_ps(_mm_cmplt_ps(_mm_and_ps(bounced, absMask), rest4), bounced);
+            py = select(hit, _mm_add_ps(ground4, hy), py);
+            vy = select(hit, bounced, vy);
+
+            _mm_storeu_ps(&velX[i], vx); _mm_storeu_ps(&velY[i], vy); _mm_storeu_ps(&velZ[i], vz);
+            _mm_storeu_ps(&posX[i], px); _mm_storeu_ps(&posY[i], py); _mm_storeu_ps(&posZ[i], pz);
+        }
+#endif
+        for (; i < end; i++) {
+            float m = dt * motion[i];
+            velX[i] += accX[i] * m;
+            velY[i] += accY[i] * m;
+            velZ[i] += accZ[i] * m;
+            if (velY[i] < -maxFallSpeed) velY[i] = -maxFallSpeed;
+
+            posX[i] += velX[i] * m;
+            posY[i] += velY[i] * m;
+            posZ[i] += velZ[i] * m;
+
+            if (m > 0.0f && posY[i] - halfY[i] <= groundHeight) {
+                posY[i] = groundHeight + halfY[i];
+                velY[i] = -velY[i] * bounce[i];
+                if (std::abs(velY[i]) < restSpeed) velY[i] = 0.0f;
+            }
+        }
+
+        updateBounds(begin, end);
+    }
+
+#ifdef PHYSICS_WORLD_SSE
+    static __m128 select(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+#endif
+
+    // boucles simples sur des tableaux contigus : vectorisees par le compilateur
+    void updateBounds(size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) { minX[i] = posX[i] - halfX[i]; maxX[i] = posX[i] + halfX[i]; }
+        for (size_t i = begin; i < end; i++) { minY[i] = posY[i] - halfY[i]; maxY[i] = posY[i] + halfY[i]; }
+        for (size_t i = begin; i < end; i++) { minZ[i] = posZ[i] - halfZ[i]; maxZ[i] = posZ[i] + halfZ[i]; }
+    }
+};
+
+#endif
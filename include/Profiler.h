@@ -0,0 +1,333 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <glad.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// zone CPU terminee : nom statique (litteral), temps en ns depuis le demarrage du profileur
+struct ProfileEvent {
+    const char* name;
+    int64_t startNs;
+    int64_t endNs;
+};
+
+// compteurs remis a zero a chaque frame
+enum ProfileCounter {
+    ProfileDraws = 0,        // commandes de dessin
+    ProfileStateChanges,     // changements d'etat GL envoyes
+    ProfileUploadBytes,      // octets envoyes au GPU (buffers, textures)
+    ProfileCounterCount
+};
+
+// resume d'une frame (thread GL)
+struct ProfileFrame {
+    uint64_t index = 0;
+    int64_t startNs = 0;
+    int64_t endNs = 0;
+    double gpuMs = -1.0;     // somme des zones GPU (connue quelques frames plus tard, -1 avant)
+    uint64_t counters[ProfileCounterCount] = {};
+};
+
+// profileur de frame :
+// - zones CPU (PROFILE_ZONE) ecrites dans un anneau par thread, un seul ecrivain, sans verrou
+// - zones GPU (GL_TIME_ELAPSED) lues avec GpuLatency frames de retard, sans jamais attendre le GPU
+// - compteurs par frame, export au format Chrome trace (chrome://tracing, Perfetto)
+class Profiler {
+public:
+    static const size_t RingCapacity = 1 << 15;   // evenements gardes par thread (puissance de 2)
+    static const size_t FrameCapacity = 1024;     // frames gardees pour l'export
+    static const int GpuLatency = 4;              // frames entre une requete GPU et sa lecture
+    static const int GpuZonesPerFrame = 16;
+
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // temps en ns depuis la creation du profileur
+    int64_t now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+    // ---- zones CPU (tous threads) ----
+
+    // name doit survivre au profileur (litteral)
+    void record(const char* name, int64_t startNs, int64_t endNs) {
+        ThreadLog& log = threadLog();
+        uint64_t head = log.head.load(std::memory_order_relaxed);
+        log.events[head & (RingCapacity - 1)] = ProfileEvent{ name, startNs, endNs };
+        log.head.store(head + 1, std::memory_order_release);
+    }
+
+    // nom du thread courant dans la trace
+    void setThreadName(const std::string& name) {
+        ThreadLog& log = threadLog();
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        log.name = name;
+    }
+
+    // ---- compteurs (tous threads) ----
+
+    void count(ProfileCounter counter, uint64_t value) {
+        counters[counter].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    // ---- frames et zones GPU (thread GL) ----
+
+    // a appeler une fois le contexte GL cree
+    void initGpu() {
+        glGenQueries(GpuLatency * GpuZonesPerFrame, &gpuQueries[0][0]);
+        gpuReady = true;
+    }
+
+    void beginFrame() {
+        current = ProfileFrame();
+        current.index = frameIndex;
+        current.startNs = now();
+        if (gpuReady) collectGpu(static_cast<int>(frameIndex % GpuLatency));
+    }
+
+    void endFrame() {
+        current.endNs = now();
+        for (int i = 0; i < ProfileCounterCount; i++)
+            current.counters[i] = counters[i].exchange(0, std::memory_order_relaxed);
+        frames[frameIndex % FrameCapacity] = current;
+        last = current;
+        frameIndex++;
+    }
+
+    // zones GPU non imbriquees (GL_TIME_ELAPSED n'accepte qu'une requete active)
+    void beginGpu(const char* name) {
+        if (!gpuReady || gpuActive) return;
+        int slot = static_cast<int>(frameIndex % GpuLatency);
+        int& used = gpuUsed[slot];
+        if (used >= GpuZonesPerFrame) return;
+        GpuZone& zone = gpuZones[slot][used];
+        zone.name = name;
+        zone.cpuNs = now();
+        zone.frame = frameIndex;
+        glBeginQuery(GL_TIME_ELAPSED, gpuQueries[slot][used]);
+        used++;
+        gpuActive = true;
+    }
+
+    void endGpu() {
+        if (!gpuActive) return;
+        glEndQuery(GL_TIME_ELAPSED);
+        gpuActive = false;
+    }
+
+    const ProfileFrame& lastFrame() const { return last; }
+    double lastGpuMs() const { return lastGpu; }
+
+    // temps GPU d'une frame encore gardee, -1 si inconnu
+    double gpuMs(uint64_t index) const {
+        if (index >= frameIndex || index + FrameCapacity < frameIndex) return -1.0;
+        return frames[index % FrameCapacity].gpuMs;
+    }
+
+    // attend le GPU et lit toutes les requetes en vol (fin d'un benchmark)
+    void flushGpu() {
+        if (!gpuReady) return;
+        glFinish();
+        for (uint64_t i = 0; i < GpuLatency; i++) collectGpu(static_cast<int>((frameIndex + i) % GpuLatency));
+    }
+
+    // ---- export ----
+
+    // ecrit toutes les zones gardees au format Chrome trace (thread GL)
+    // les anneaux des autres threads peuvent avancer pendant la lecture : les evenements
+    // ecrases entre-temps sont ecartes
+    bool exportChromeTrace(const std::string& path) {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) {
+            std::cerr << "Profileur : impossible d'ecrire " << path << std::endl;
+            return false;
+        }
+        out.setf(std::ios::fixed);
+        out.precision(3);   // microsecondes avec la precision de la ns
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        auto separator = [&]() -> std::ofstream& {
+            if (!first) out << ",\n";
+            first = false;
+            return out;
+        };
+
+        size_t written = 0;
+        std::vector<ProfileEvent> copy;
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        for (size_t t = 0; t < threads.size(); t++) {
+            ThreadLog& log = *threads[t];
+            separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t << ",\"args\":{\"name\":\""
+                        << escape(log.name) << "\"}}";
+
+            uint64_t end = log.head.load(std::memory_order_acquire);
+            uint64_t begin = end > RingCapacity ? end - RingCapacity : 0;
+            copy.clear();
+            for (uint64_t i = begin; i < end; i++) copy.push_back(log.events[i & (RingCapacity - 1)]);
+            // l'ecrivain a pu ecraser le debut de la copie : les evenements avant after sont publies,
+            // et il peut etre en train d'ecrire l'evenement after, dans le meme emplacement que after - RingCapacity
+            uint64_t after = log.head.load(std::memory_order_acquire);
+            size_t skip = after + 1 > RingCapacity && after + 1 - RingCapacity > begin ? static_cast<size_t>(after + 1 - RingCapacity - begin) : 0;
+            for (size_t i = std::min(skip, copy.size()); i < copy.size(); i++) {
+                writeComplete(separator(), copy[i].name, t, copy[i].startNs, copy[i].endNs);
+                written++;
+            }
+        }
+
+        // piste GPU (debut approche par l'instant CPU de la requete)
+        const size_t gpuTid = threads.size();
+        separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << gpuTid << ",\"args\":{\"name\":\"GPU\"}}";
+        for (const ProfileEvent& event : gpuEvents) {
+            writeComplete(separator(), event.name, gpuTid, event.startNs, event.endNs);
+            written++;
+        }
+
+        // frames (piste a part) et compteurs
+        const size_t frameTid = gpuTid + 1;
+        separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << frameTid << ",\"args\":{\"name\":\"frames\"}}";
+        const char* counterNames[ProfileCounterCount] = { "draws", "changements d'etat", "octets envoyes" };
+        size_t frameCount = static_cast<size_t>(std::min<uint64_t>(frameIndex, FrameCapacity));
+        for (size_t i = 0; i < frameCount; i++) {
+            const ProfileFrame& frame = frames[(frameIndex - frameCount + i) % FrameCapacity];
+            writeComplete(separator(), "frame", frameTid, frame.startNs, frame.endNs);
+            for (int c = 0; c < ProfileCounterCount; c++) {
+                separator() << "{\"name\":\"" << counterNames[c] << "\",\"ph\":\"C\",\"pid\":1,\"ts\":" << micro(frame.startNs)
+                            << ",\"args\":{\"valeur\":" << frame.counters[c] << "}}";
+            }
+        }
+        out << "\n]}\n";
+
+        std::cout << "Profileur : " << written << " zones et " << frameCount << " frames ecrites dans " << path << std::endl;
+        return static_cast<bool>(out);
+    }
+
+    // a appeler tant que le contexte existe encore
+    void release() {
+        if (!gpuReady) return;
+        glDeleteQueries(GpuLatency * GpuZonesPerFrame, &gpuQueries[0][0]);
+        gpuReady = false;
+    }
+
+private:
+    struct ThreadLog {
+        std::string name;
+        std::unique_ptr<ProfileEvent[]> events{ new ProfileEvent[RingCapacity] };
+        std::atomic<uint64_t> head{ 0 };   // nombre total d'evenements ecrits
+    };
+
+    struct GpuZone {
+        const char* name = nullptr;
+        int64_t cpuNs = 0;
+        uint64_t frame = 0;
+    };
+
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+    // un journal par thread, cree a son premier evenement et garde jusqu'a la fin
+    std::mutex threadsMutex;
+    std::vector<std::unique_ptr<ThreadLog>> threads;
+
+    std::atomic<uint64_t> counters[ProfileCounterCount] = {};
+
+    // thread GL uniquement
+    uint64_t frameIndex = 0;
+    ProfileFrame current, last;
+    ProfileFrame frames[FrameCapacity];
+
+    GLuint gpuQueries[GpuLatency][GpuZonesPerFrame] = {};
+    GpuZone gpuZones[GpuLatency][GpuZonesPerFrame];
+    int gpuUsed[GpuLatency] = {};
+    bool gpuReady = false, gpuActive = false;
+    double lastGpu = 0.0;
+    std::vector<ProfileEvent> gpuEvents;   // borne a RingCapacity (les plus anciens sont retires)
+
+    Profiler() = default;
+
+    ThreadLog& threadLog() {
+        static thread_local ThreadLog* log = nullptr;
+        if (!log) {
+            std::lock_guard<std::mutex> lock(threadsMutex);
+            threads.emplace_back(new ThreadLog());
+            log = threads.back().get();
+            log->name = "thread " + std::to_string(threads.size() - 1);
+        }
+        return *log;
+    }
+
+    // lit les requetes posees GpuLatency frames plus tot ; une requete pas encore prete est abandonnee
+    // plutot que d'attendre le GPU, et le total de la frame devient inconnu (-1) plutot que partiel
+    void collectGpu(int slot) {
+        double total = 0.0;
+        bool missing = false;
+        for (int i = 0; i < gpuUsed[slot]; i++) {
+            GLuint available = 0;
+            glGetQueryObjectuiv(gpuQueries[slot][i], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                missing = true;
+                continue;
+            }
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(gpuQueries[slot][i], GL_QUERY_RESULT, &elapsed);
+            const GpuZone& zone = gpuZones[slot][i];
+            if (gpuEvents.size() >= RingCapacity) gpuEvents.erase(gpuEvents.begin(), gpuEvents.begin() + RingCapacity / 2);
+            gpuEvents.push_back(ProfileEvent{ zone.name, zone.cpuNs, zone.cpuNs + static_cast<int64_t>(elapsed) });
+            total += static_cast<double>(elapsed) / 1e6;
+        }
+        if (gpuUsed[slot] > 0) {
+            if (!missing) lastGpu = total;
+            uint64_t frame = gpuZones[slot][0].frame;
+            if (frame < frameIndex && frame + FrameCapacity >= frameIndex) frames[frame % FrameCapacity].gpuMs = missing ? -1.0 : total;
+        }
+        gpuUsed[slot] = 0;
+    }
+
+    static double micro(int64_t ns) { return static_cast<double>(ns) / 1000.0; }
+
+    static std::string escape(const std::string& text) {
+        std::string result;
+        for (char c : text) {
+            if (c == '"' || c == '\\') result += '\\';
+            result += c;
+        }
+        return result;
+    }
+
+    static void writeComplete(std::ostream& out, const char* name, size_t tid, int64_t startNs, int64_t endNs) {
+        out << "{\"name\":\"" << escape(name ? name : "?") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+            << ",\"ts\":" << micro(startNs) << ",\"dur\":" << micro(endNs - startNs) << "}";
+    }
+};
+
+// zone CPU mesuree de la construction a la destruction
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : name(name), start(Profiler::instance().now()) {}
+    ~ProfileScope() { Profiler::instance().record(name, start, Profiler::instance().now()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    int64_t start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+
+#endif
@@ -0,0 +1,275 @@
+#ifndef RAY_QUERY_H
+#define RAY_QUERY_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include <glm/glm.hpp>
+#include "BVH.h"
+#include "JobSystem.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// rayon d'une requete groupee
+struct Ray {
+    glm::vec3 origin;
+    float tMax = std::numeric_limits<float>::infinity();
+    glm::vec3 direction;
+};
+
+// premier objet touche (object = RayResult::None si rien)
+struct RayResult {
+    static const uint32_t None = 0xFFFFFFFFu;
+    uint32_t object = None;
+    float distance = 0.0f;
+};
+
+// test rayon / boite avec direction inverse precalculee ; tEnter recoit la distance d'entree
+inline bool raySlab(const glm::vec3& origin, const glm::vec3& invDir, const glm::vec3& boxMin, const glm::vec3& boxMax,
+                    float tMax, float& tEnter) {
+    glm::vec3 t0 = (boxMin - origin) * invDir;
+    glm::vec3 t1 = (boxMax - origin) * invDir;
+    glm::vec3 tNear = glm::min(t0, t1), tFar = glm::max(t0, t1);
+    tEnter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+    float tExit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, tMax));
+    return tEnter <= tExit;
+}
+
+// requetes de rayons groupees contre les boites englobantes de tous les objets de la scene
+// BVH de haut niveau dont chaque feuille porte jusqu'a 8 boites en structure de tableaux
+class SceneRayQuery {
+public:
+    static const int PacketSize = 8;
+    static const size_t RaysPerJob = 1024;   // taille des tranches confiees au systeme de jobs
+
+    // reconstruit la hierarchie (a refaire quand les objets bougent)
+    void build(const std::vector<glm::vec3>& boundsMin, const std::vector<glm::vec3>& boundsMax) {
+        const uint32_t count = static_cast<uint32_t>(boundsMin.size());
+        nodes.clear();
+        packets.clear();
+        order.resize(count);
+        std::iota(order.begin(), order.end(), 0u);
+        if (count == 0) return;
+
+        nodes.reserve(2 * (count / PacketSize + 1));
+        packets.reserve(count / PacketSize + 1);
+
+        // decoupage median sur l'axe le plus long des centres (les objets sont peu nombreux)
+        struct Range { uint32_t node, first, count; };
+        std::vector<Range> stack;
+        nodes.push_back(BVHNode());
+        stack.push_back({ 0, 0, count });
+        while (!stack.empty()) {
+            Range r = stack.back();
+            stack.pop_back();
+
+            glm::vec3 mn(std::numeric_limits<float>::max()), mx(-std::numeric_limits<float>::max());
+            glm::vec3 cMin = mn, cMax = mx;
+            for (uint32_t i = r.first; i < r.first + r.count; i++) {
+                mn = glm::min(mn, boundsMin[order[i]]);
+                mx = glm::max(mx, boundsMax[order[i]]);
+                glm::vec3 c = (boundsMin[order[i]] + boundsMax[order[i]]) * 0.5f;
+                cMin = glm::min(cMin, c);
+                cMax = glm::max(cMax, c);
+            }
+            nodes[r.node].boundsMin = mn;
+            nodes[r.node].boundsMax = mx;
+
+            if (r.count <= PacketSize) {
+                nodes[r.node].leftFirst = static_cast<uint32_t>(packets.size());
+                nodes[r.node].count = r.count;
+                packets.push_back(makePacket(boundsMin, boundsMax, r.first, r.count));
+                continue;
+            }
+
+            glm::vec3 extent = cMax - cMin;
+            int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+            uint32_t half = r.count / 2;
+            std::nth_element(order.begin() + r.first, order.begin() + r.first + half, order.begin() + r.first + r.count,
+                             [&](uint32_t a, uint32_t b) {
+                                 return boundsMin[a][axis] + boundsMax[a][axis] < boundsMin[b][axis] + boundsMax[b][axis];
+                             });
+
+            uint32_t left = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(BVHNode());
+            nodes.push_back(BVHNode());
+            nodes[r.node].leftFirst = left;
+            nodes[r.node].count = 0;
+            stack.push_back({ left, r.first, half });
+            stack.push_back({ left + 1, r.first + half, r.count - half });
+        }
+    }
+
+    size_t objectCount() const { return order.size(); }
+
+    // lance count rayons ; results doit avoir count cases (aucune allocation par rayon)
+    // les tranches de rayons sont reparties sur les threads du systeme de jobs
+    void cast(const Ray* rays, size_t count, RayResult* results, JobSystem& jobs = JobSystem::instance()) const {
+        jobs.parallelFor(0, count, RaysPerJob, [&](size_t begin, size_t end) { castRange(rays, results, begin, end); });
+    }
+
+    // un seul rayon
+    RayResult cast(const Ray& ray) const {
+        RayResult result;
+        castRange(&ray, &result, 0, 1);
+        return result;
+    }
+
+    // test exact par objet (picking sur les triangles) : intersect(objet, closest) est appele pour
+    // chaque boite touchee avant closest, et raccourcit closest quand l'objet est touche
+    // renvoie l'objet touche le plus proche (RayResult::None si aucun)
+    template <typename Intersect>
+    RayResult castExact(const Ray& ray, Intersect&& intersect) const {
+        RayResult result;
+        float closest = ray.tMax;
+        traverse(ray, closest, [&](const BoxPacket& p, const glm::vec3& invDir) {
+            alignas(32) float enter[PacketSize];
+            int hits = packetHits(p, ray.origin, invDir, closest, enter);
+            for (int i = 0; i < PacketSize; i++) {
+                if ((hits & (1 << i)) && enter[i] <= closest && intersect(p.object[i], closest)) result.object = p.object[i];
+            }
+        });
+        if (result.object != RayResult::None) result.distance = closest;
+        return result;
+    }
+
+private:
+    struct alignas(32) BoxPacket {
+        float minX[PacketSize], minY[PacketSize], minZ[PacketSize];
+        float maxX[PacketSize], maxY[PacketSize], maxZ[PacketSize];
+        uint32_t object[PacketSize];
+        uint32_t count;   // voies utilisees
+    };
+
+    std::vector<BVHNode> nodes;       // meme format que la BVH de triangles ; feuille -> paquet
+    std::vector<BoxPacket> packets;
+    std::vector<uint32_t> order;
+
+    BoxPacket makePacket(const std::vector<glm::vec3>& boundsMin, const std::vector<glm::vec3>& boundsMax,
+                         uint32_t first, uint32_t count) const {
+        BoxPacket p;
+        for (int i = 0; i < PacketSize; i++) {
+            // cases vides : boite quelconque, masquee par count au moment du test
+            bool used = static_cast<uint32_t>(i) < count;
+            glm::vec3 mn = used ? boundsMin[order[first + i]] : glm::vec3(0.0f);
+            glm::vec3 mx = used ? boundsMax[order[first + i]] : glm::vec3(0.0f);
+            p.minX[i] = mn.x; p.minY[i] = mn.y; p.minZ[i] = mn.z;
+            p.maxX[i] = mx.x; p.maxY[i] = mx.y; p.maxZ[i] = mx.z;
+            p.object[i] = used ? order[first + i] : RayResult::None;
+        }
+        p.count = count;
+        return p;
+    }
+
+    void castRange(const Ray* rays, RayResult* results, size_t begin, size_t end) const {
+        for (size_t r = begin; r < end; r++) {
+            const Ray& ray = rays[r];
+            RayResult result;
+            float closest = ray.tMax;
+            traverse(ray, closest, [&](const BoxPacket& p, const glm::vec3& invDir) {
+                testPacket(p, ray.origin, invDir, closest, result);
+            });
+            if (result.object != RayResult::None) result.distance = closest;
+            results[r] = result;
+        }
+    }
+
+    // parcours des noeuds touches avant closest, le plus proche d'abord ; leaf(paquet, invDir) par feuille
+    template <typename Leaf>
+    void traverse(const Ray& ray, const float& closest, Leaf&& leaf) const {
+        if (nodes.empty()) return;
+        const glm::vec3 invDir = safeInverse(ray.direction);
+        uint32_t stack[64];
+        float stackEnter[64];
+        uint32_t stackSize = 0;
+        float rootEnter;
+        if (raySlab(ray.origin, invDir, nodes[0].boundsMin, nodes[0].boundsMax, closest, rootEnter)) {
+            stack[0] = 0;
+            stackEnter[0] = rootEnter;
+            stackSize = 1;
+        }
+        while (stackSize > 0) {
+            stackSize--;
+            if (stackEnter[stackSize] > closest) continue; // un objet plus proche a deja ete touche
+            const BVHNode& node = nodes[stack[stackSize]];
+            if (node.isLeaf()) {
+                leaf(packets[node.leftFirst], invDir);
+                continue;
+            }
+            // enfant le plus proche en haut de la pile
+            uint32_t a = node.leftFirst, b = node.leftFirst + 1;
+            float tA, tB;
+            bool hitA = raySlab(ray.origin, invDir, nodes[a].boundsMin, nodes[a].boundsMax, closest, tA);
+            bool hitB = raySlab(ray.origin, invDir, nodes[b].boundsMin, nodes[b].boundsMax, closest, tB);
+            if (hitA && hitB && tA < tB) { std::swap(a, b); std::swap(tA, tB); }
+            if (hitA) { stack[stackSize] = a; stackEnter[stackSize++] = tA; }
+            if (hitB) { stack[stackSize] = b; stackEnter[stackSize++] = tB; }
+        }
+    }
+
+    // 8 boites d'un coup : on garde la plus proche touchee
+    static void testPacket(const BoxPacket& p, const glm::vec3& o, const glm::vec3& inv, float& closest, RayResult& result) {
+        alignas(32) float enter[PacketSize];
+        int hits = packetHits(p, o, inv, closest, enter);
+        for (int i = 0; i < PacketSize; i++) {
+            if ((hits & (1 << i)) && enter[i] < closest) {
+                closest = enter[i];
+                result.object = p.object[i];
+            }
+        }
+    }
+
+    // tEnter/tExit par voie : masque des boites touchees avant closest, distances d'entree dans enter
+    static int packetHits(const BoxPacket& p, const glm::vec3& o, const glm::vec3& inv, float closest, float* enter) {
+        int hits = 0;
+#if defined(__AVX__)
+        __m256 t0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(p.minX), _mm256_set1_ps(o.x)), _mm256_set1_ps(inv.x));
+        __m256 t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(p.maxX), _mm256_set1_ps(o.x)), _mm256_set1_ps(inv.x));
+        __m256 tNear = _mm256_min_ps(t0, t1), tFar = _mm256_max_ps(t0, t1);
+        t0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(p.minY), _mm256_set1_ps(o.y)), _mm256_set1_ps(inv.y));
+        t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(p.maxY), _mm256_set1_ps(o.y)), _mm256_set1_ps(inv.y));
+        tNear = _mm256_max_ps(tNear, _mm256_min_ps(t0, t1));
+        tFar = _mm256_min_ps(tFar, _mm256_max_ps(t0, t1));
+        t0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(p.minZ), _mm256_set1_ps(o.z)), _mm256_set1_ps(inv.z));
+        t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(p.maxZ), _mm256_set1_ps(o.z)), _mm256_set1_ps(inv.z));
+        tNear = _mm256_max_ps(_mm256_max_ps(tNear, _mm256_min_ps(t0, t1)), _mm256_setzero_ps());
+        tFar = _mm256_min_ps(_mm256_min_ps(tFar, _mm256_max_ps(t0, t1)), _mm256_set1_ps(closest));
+        hits = _mm256_movemask_ps(_mm256_cmp_ps(tNear, tFar, _CMP_LE_OQ));
+        _mm256_store_ps(enter, tNear);
+#elif defined(__SSE2__) || defined(_M_X64)
+        for (int half = 0; half < PacketSize; half += 4) {
+            __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(p.minX + half), _mm_set1_ps(o.x)), _mm_set1_ps(inv.x));
+            __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(p.maxX + half), _mm_set1_ps(o.x)), _mm_set1_ps(inv.x));
+            __m128 tNear = _mm_min_ps(t0, t1), tFar = _mm_max_ps(t0, t1);
+            t0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(p.minY + half), _mm_set1_ps(o.y)), _mm_set1_ps(inv.y));
+            t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(p.maxY + half), _mm_set1_ps(o.y)), _mm_set1_ps(inv.y));
+            tNear = _mm_max_ps(tNear, _mm_min_ps(t0, t1));
+            tFar = _mm_min_ps(tFar, _mm_max_ps(t0, t1));
+            t0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(p.minZ + half), _mm_set1_ps(o.z)), _mm_set1_ps(inv.z));
+            t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(p.maxZ + half), _mm_set1_ps(o.z)), _mm_set1_ps(inv.z));
+            tNear = _mm_max_ps(_mm_max_ps(tNear, _mm_min_ps(t0, t1)), _mm_setzero_ps());
+            tFar = _mm_min_ps(_mm_min_ps(tFar, _mm_max_ps(t0, t1)), _mm_set1_ps(closest));
+            hits |= _mm_movemask_ps(_mm_cmple_ps(tNear, tFar)) << half;
+            _mm_store_ps(enter + half, tNear);
+        }
+#else
+        for (int i = 0; i < PacketSize; i++) {
+            float tEnter;
+            if (raySlab(o, inv, glm::vec3(p.minX[i], p.minY[i], p.minZ[i]), glm::vec3(p.maxX[i], p.maxY[i], p.maxZ[i]), closest, tEnter)) {
+                hits |= 1 << i;
+                enter[i] = tEnter;
+            }
+        }
+#endif
+        return hits & ((1 << p.count) - 1);
+    }
+};
+
+#endif
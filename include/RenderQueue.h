@@ -0,0 +1,221 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <glm/glm.hpp>
+#include "GeometryArena.h"
+#include "InstanceData.h"
+#include "Mesh.h"
+#include "Shader.h"
+
+// emplacements des uniformes de dessin, resolus une fois par shader
+struct DrawUniforms {
+    UniformHandle model, instanced, layer;
+    UniformHandle decodePosition, decodeTexCoord, octNormals;
+
+    explicit DrawUniforms(const Shader& shader)
+        : model(shader.uniform("model")), instanced(shader.uniform("instanced")), layer(shader.uniform("layer")),
+          decodePosition(shader.uniform("decodePosition")), decodeTexCoord(shader.uniform("decodeTexCoord")),
+          octNormals(shader.uniform("octNormals")) {}
+};
+
+// envoie au shader les parametres de decodage des sommets
+inline void applyVertexDecode(const Shader& shader, const DrawUniforms& uniforms, const VertexDecode& decode) {
+    shader.set(uniforms.decodePosition, decode.position);
+    shader.set(uniforms.decodeTexCoord, decode.texcoord);
+    shader.set(uniforms.octNormals, decode.octNormals);
+}
+
+// un appel de dessin soumis a la file ; l'etat qu'il demande n'est applique
+// que s'il differe de celui du draw precedent
+struct DrawPacket {
+    Shader* shader = nullptr;
+    const DrawUniforms* uniforms = nullptr;   // emplacements du shader
+    GLuint vao = 0;
+    GLenum textureTarget = GL_TEXTURE_2D_ARRAY;
+    GLuint texture = 0;
+    const VertexDecode* decode = nullptr;     // null : sommets float (pas de decodage)
+
+    // batch non nul : toutes les commandes de l'arene (vao = batch->vao()), decodage par instance
+    // sinon draw simple avec la matrice model et la couche layer
+    GeometryArena* batch = nullptr;
+    glm::mat4 model = glm::mat4(1.0f);
+    float layer = 0.0f;
+
+    GLenum mode = GL_TRIANGLES;
+    GLenum indexType = GL_UNSIGNED_INT;
+    GLsizei indexCount = 0;
+    size_t indexOffset = 0;                   // en octets dans l'EBO du VAO
+};
+
+struct RenderQueueStats {
+    size_t draws = 0;            // commandes de dessin (une par (modele, LOD) dans un batch)
+    size_t batches = 0;          // appels multi-draw (un par arene)
+    size_t stateChanges = 0;     // programmes, textures, VAO et uniformes reellement envoyes
+    size_t avoidedChanges = 0;   // changements evites car identiques au draw precedent
+    size_t uploadBytes = 0;      // instances et commandes indirectes envoyees
+    double sortMs = 0.0;
+};
+
+// file de dessin triee par cle 64 bits (programme | texture | VAO | profondeur) :
+// les draws qui partagent un etat se suivent, la profondeur trie d'avant en arriere
+// a l'interieur d'un meme etat (moins d'overdraw pour les objets opaques)
+class RenderQueue {
+public:
+    float depthRange = 100.0f;   // distance de vue ramenee sur 16 bits (plan lointain)
+
+    void clear() {
+        packets.clear();
+        entries.clear();
+    }
+
+    void reserve(size_t count) {
+        packets.reserve(count);
+        entries.reserve(count);
+        scratch.reserve(count);
+    }
+
+    // viewDepth : distance a la camera (tri d'avant en arriere)
+    void submit(const DrawPacket& packet, float viewDepth) {
+        SortEntry entry;
+        entry.key = makeKey(packet.shader ? packet.shader->ID : 0, packet.texture, packet.vao, viewDepth / depthRange);
+        entry.index = static_cast<uint32_t>(packets.size());
+        entries.push_back(entry);
+        packets.push_back(packet);
+    }
+
+    size_t size() const { return packets.size(); }
+
+    // cle : [63..56] programme | [55..44] texture | [43..32] VAO | [31..16] profondeur | [15..0] libre
+    // les noms GL sont tronques : une collision ne change que l'ordre, pas le resultat,
+    // car execute() compare les vrais objets avant de les lier
+    static uint64_t makeKey(GLuint program, GLuint texture, GLuint vao, float depth01) {
+        uint64_t depth = static_cast<uint64_t>(std::min(std::max(depth01, 0.0f), 1.0f) * 65535.0f);
+        return (static_cast<uint64_t>(program & 0xFF) << 56) | (static_cast<uint64_t>(texture & 0xFFF) << 44) |
+               (static_cast<uint64_t>(vao & 0xFFF) << 32) | (depth << 16);
+    }
+
+    // tri puis envoi de tous les draws ; l'etat GL est remis a zero a la fin
+    const RenderQueueStats& execute() {
+        stats = RenderQueueStats();
+        auto sortStart = std::chrono::high_resolution_clock::now();
+        sort();
+        stats.sortMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - sortStart).count();
+
+        GLuint program = 0, texture = 0, vao = 0;
+        GLenum textureTarget = 0;
+        // uniformes en cache pour le programme courant (invalides a chaque changement de programme)
+        int instanced = -1;
+        const VertexDecode* decode = nullptr;
+        bool decodeSet = false;
+        const VertexDecode identity;
+
+        for (const SortEntry& entry : entries) {
+            const DrawPacket& p = packets[entry.index];
+            if (!p.shader || !p.uniforms) continue;
+
+            if (p.shader->ID != program) {
+                program = p.shader->ID;
+                glUseProgram(program);
+                instanced = -1;
+                decodeSet = false;
+                stats.stateChanges++;
+            } else stats.avoidedChanges++;
+
+            if (p.texture != texture || p.textureTarget != textureTarget) {
+                texture = p.texture;
+                textureTarget = p.textureTarget;
+                glBindTexture(textureTarget, texture);
+                stats.stateChanges++;
+            } else stats.avoidedChanges++;
+
+            if (p.vao != vao) {
+                vao = p.vao;
+                glBindVertexArray(vao);
+                stats.stateChanges++;
+            } else stats.avoidedChanges++;
+
+            int wantInstanced = p.batch ? 1 : 0;
+            if (wantInstanced != instanced) {
+                instanced = wantInstanced;
+                p.shader->set(p.uniforms->instanced, instanced != 0);
+                stats.stateChanges++;
+            } else stats.avoidedChanges++;
+
+            if (p.batch) {
+                // decodage lu dans les attributs d'instance : les uniformes ne servent pas
+                p.batch->draw();
+                stats.draws += p.batch->statistics().commands;
+                stats.batches++;
+                stats.uploadBytes += p.batch->statistics().uploadBytes;
+                continue;
+            }
+
+            if (!decodeSet || !sameDecode(p.decode ? *p.decode : identity, decode ? *decode : identity)) {
+                decode = p.decode;
+                decodeSet = true;
+                applyVertexDecode(*p.shader, *p.uniforms, p.decode ? *p.decode : identity);
+                stats.stateChanges++;
+            } else stats.avoidedChanges++;
+
+            p.shader->set(p.uniforms->model, p.model);
+            p.shader->set(p.uniforms->layer, p.layer);
+            glDrawElements(p.mode, p.indexCount, p.indexType, (void*)p.indexOffset);
+            stats.draws++;
+        }
+
+        glBindVertexArray(0);
+        return stats;
+    }
+
+    const RenderQueueStats& statistics() const { return stats; }
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;   // dans packets (ordre de soumission en cas d'egalite : tri stable)
+    };
+
+    std::vector<DrawPacket> packets;
+    std::vector<SortEntry> entries;
+    std::vector<SortEntry> scratch;
+    RenderQueueStats stats;
+
+    static bool sameDecode(const VertexDecode& a, const VertexDecode& b) {
+        return a.octNormals == b.octNormals && std::memcmp(&a.texcoord, &b.texcoord, sizeof(a.texcoord)) == 0 &&
+               std::memcmp(&a.position, &b.position, sizeof(a.position)) == 0;
+    }
+
+    // tri par base 256, octet de poids faible d'abord (8 passes au plus, stable) ;
+    // une passe dont toutes les cles ont le meme octet est sautee
+    void sort() {
+        const size_t n = entries.size();
+        if (n < 2) return;
+        scratch.resize(n);
+        SortEntry* src = entries.data();
+        SortEntry* dst = scratch.data();
+        for (int shift = 0; shift < 64; shift += 8) {
+            size_t counts[256] = {};
+            for (size_t i = 0; i < n; i++) counts[(src[i].key >> shift) & 0xFF]++;
+            if (counts[(src[0].key >> shift) & 0xFF] == n) continue;
+
+            size_t offsets[256];
+            size_t sum = 0;
+            for (int b = 0; b < 256; b++) {
+                offsets[b] = sum;
+                sum += counts[b];
+            }
+            for (size_t i = 0; i < n; i++) dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+            std::swap(src, dst);
+        }
+        if (src != entries.data()) std::memcpy(entries.data(), src, n * sizeof(SortEntry));
+    }
+};
+
+#endif
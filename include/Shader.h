@@ -3,26 +3,171 @@
 #define SHADER_H
 
 #include <glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
 #include <string>
+#include <unordered_map>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "JobSystem.h"
+#include "ShaderCache.h"
+
+// emplacement d'uniforme resolu a l'avance (-1 : absent du programme, l'appel est ignore par GL)
+typedef GLint UniformHandle;
 
 class Shader {
 public:
     unsigned int ID;
 
-    Shader(const char* vertexPath, const char* fragmentPath) {
-        // lire les fichiers shader
-        std::string vertexCode;
-        std::string fragmentCode;
+    // FNV-1a : cle de la table des uniformes (constexpr pour hacher les noms a la compilation)
+    static constexpr uint32_t hash(const char* name, uint32_t h = 2166136261u) {
+        return *name ? hash(name + 1, (h ^ static_cast<uint8_t>(*name)) * 16777619u) : h;
+    }
+
+    Shader(const char* vertexPath, const char* fragmentPath) : vertexPath(vertexPath), fragmentPath(fragmentPath) {
+        std::string vertexCode, fragmentCode;
+        if (!readSources(vertexCode, fragmentCode)) {
+            ID = 0;
+            return;
+        }
+        ID = build(vertexCode, fragmentCode);
+        reflect();
+        fileStamp(vertexStamp, fragmentStamp);
+    }
+
+    ~Shader() { jobs().wait(watchJob); }
+
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+
+    // rechargement a chaud : surveille les deux fichiers sources
+    bool hotReload = false;
+
+    // a appeler chaque frame sur le thread GL. Un job verifie les dates des fichiers
+    // (au plus toutes les 0.5 s) et relit les sources modifiees ; le nouveau programme
+    // ne remplace l'ancien que s'il se lie sans erreur. Vrai si le programme a change :
+    // les emplacements d'uniformes et liaisons de blocs sont alors a refaire
+    bool pollReload() {
+        if (!hotReload || !watchJob.done()) return false;
+
+        bool swapped = false;
+        if (reloadReady) {
+            reloadReady = false;
+            GLuint program = build(pendingVertex, pendingFragment);
+            GLint linked = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            if (linked) {
+                glDeleteProgram(ID);
+                ID = program;
+                reflect();
+                swapped = true;
+                std::cout << "Shader recharge : " << vertexPath << ", " << fragmentPath << std::endl;
+            } else {
+                glDeleteProgram(program);
+                std::cerr << "Shader : rechargement refuse, l'ancien programme reste actif" << std::endl;
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastWatch > std::chrono::milliseconds(500)) {
+            lastWatch = now;
+            jobs().runBackground([this] {
+                int64_t vertex = 0, fragment = 0;
+                if (!fileStamp(vertex, fragment) || (vertex == vertexStamp && fragment == fragmentStamp)) return;
+                vertexStamp = vertex;
+                fragmentStamp = fragment;
+                reloadReady = readSources(pendingVertex, pendingFragment);
+            }, &watchJob);
+        }
+        return swapped;
+    }
+
+    void use() {
+        glUseProgram(ID);
+    }
+
+    // emplacement d'un uniforme actif (a resoudre une fois, hors de la boucle de rendu)
+    UniformHandle uniform(const char* name) const { return uniform(hash(name)); }
+    UniformHandle uniform(const std::string& name) const { return uniform(hash(name.c_str())); }
+    UniformHandle uniform(uint32_t nameHash) const {
+        auto it = uniforms.find(nameHash);
+        return it == uniforms.end() ? -1 : it->second;
+    }
+
+    // indice d'un bloc d'uniformes actif (GL_INVALID_INDEX si absent)
+    GLuint block(const char* name) const {
+        auto it = blocks.find(hash(name));
+        return it == blocks.end() ? GL_INVALID_INDEX : it->second;
+    }
+
+    // relie un bloc au point de liaison d'un UniformBuffer ; faux si le bloc n'existe pas
+    bool bindBlock(const char* name, GLuint binding) const {
+        GLuint index = block(name);
+        if (index == GL_INVALID_INDEX) return false;
+        glUniformBlockBinding(ID, index, binding);
+        return true;
+    }
+
+    // setters types sur des emplacements precalcules (programme deja actif)
+    void set(UniformHandle location, int value) const { glUniform1i(location, value); }
+    void set(UniformHandle location, bool value) const { glUniform1i(location, static_cast<int>(value)); }
+    void set(UniformHandle location, float value) const { glUniform1f(location, value); }
+    void set(UniformHandle location, const glm::vec3& value) const { glUniform3fv(location, 1, &value[0]); }
+    void set(UniformHandle location, const glm::vec4& value) const { glUniform4fv(location, 1, &value[0]); }
+    void set(UniformHandle location, const glm::mat4& value) const { glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]); }
+
+    // par nom : une recherche dans la table (pas d'appel au pilote), pour le code hors boucle
+    void setInt(const std::string& name, int value) const {
+        set(uniform(name), value);
+    }
+
+    void setBool(const std::string& name, bool value) const {
+        set(uniform(name), value);
+    }
+
+    void setFloat(const std::string& name, float value) const {
+        set(uniform(name), value);
+    }
+
+    void setMat4(const std::string &name, const glm::mat4 &mat) const {
+        set(uniform(name), mat);
+    }
+    
+    void setVec3(const std::string &name, const glm::vec3 &value) const {
+        set(uniform(name), value);
+    }
+
+    void setVec4(const std::string &name, const glm::vec4 &value) const {
+        set(uniform(name), value);
+    }
+
+private:
+    std::string vertexPath, fragmentPath;
+
+    // surveillance des fichiers (le job et le thread GL ne se chevauchent jamais :
+    // pollReload ne lit ces champs qu'une fois watchJob termine)
+    JobCounter watchJob;
+    std::chrono::steady_clock::time_point lastWatch = std::chrono::steady_clock::now();
+    int64_t vertexStamp = 0, fragmentStamp = 0;
+    bool reloadReady = false;
+    std::string pendingVertex, pendingFragment;
+
+    std::unordered_map<uint32_t, GLint> uniforms;   // hash du nom -> emplacement
+    std::unordered_map<uint32_t, GLuint> blocks;    // hash du nom -> indice de bloc
+
+    static JobSystem& jobs() { return JobSystem::instance(); }
+
+    bool readSources(std::string& vertexCode, std::string& fragmentCode) const {
         std::ifstream vShaderFile;
         std::ifstream fShaderFile;
 
-        // ensure 
+        // exceptions sur les erreurs de lecture
         vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
         fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
 
@@ -31,28 +176,50 @@ public:
             vShaderFile.open(vertexPath);
             fShaderFile.open(fragmentPath);
             
-            // lis les bufgers des fhichiers
+            // lis les buffers des fichiers
             std::stringstream vShaderStream, fShaderStream;
             vShaderStream << vShaderFile.rdbuf();
             fShaderStream << fShaderFile.rdbuf();
             
-            // ferme le handler
-            vShaderFile.close();
-            fShaderFile.close();
-            
             // convertion du stream vers du string
             vertexCode = vShaderStream.str();
             fragmentCode = fShaderStream.str();
-
-            // debug 
-            std::cout << "Vertex Shader Content:\n" << vertexCode << "\n\n";
-            std::cout << "Fragment Shader Content:\n" << fragmentCode << "\n\n";
         }
         catch(std::ifstream::failure& e) {
             std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
             std::cerr << "Vertex path: " << vertexPath << std::endl;
             std::cerr << "Fragment path: " << fragmentPath << std::endl;
-            return;
+            return false;
+        }
+        return true;
+    }
+
+    // dates de modification des deux sources
+    bool fileStamp(int64_t& vertex, int64_t& fragment) const {
+        std::error_code ec;
+        auto v = std::filesystem::last_write_time(vertexPath, ec);
+        if (ec) return false;
+        auto f = std::filesystem::last_write_time(fragmentPath, ec);
+        if (ec) return false;
+        vertex = static_cast<int64_t>(v.time_since_epoch().count());
+        fragment = static_cast<int64_t>(f.time_since_epoch().count());
+        return true;
+    }
+
+    // programme depuis le cache binaire si possible, sinon compilation complete (puis mise en cache)
+    GLuint build(const std::string& vertexCode, const std::string& fragmentCode) {
+        static const bool cacheSupported = ShaderCache::supported();
+        uint64_t key = 0;
+        GLuint program = glCreateProgram();
+        if (cacheSupported) {
+            key = ShaderCache::key(vertexCode, fragmentCode, ShaderCache::driverString());
+            if (ShaderCache::load(program, key)) {
+                std::cout << "Shader : " << vertexPath << " charge depuis " << ShaderCache::cachePath(key) << std::endl;
+                return program;
+            }
+            // binaire refuse : on repart d'un programme neuf
+            glDeleteProgram(program);
+            program = glCreateProgram();
         }
 
         const char* vShaderCode = vertexCode.c_str();
@@ -70,35 +237,62 @@ public:
         glCompileShader(fragmentShader);
         checkCompileErrors(fragmentShader, "FRAGMENT");
 
-        // creer le programme
-        ID = glCreateProgram();
-        glAttachShader(ID, vertexShader);
-        glAttachShader(ID, fragmentShader);
-        glLinkProgram(ID);
-        checkCompileErrors(ID, "PROGRAM");
+        // lie le programme
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, fragmentShader);
+        if (cacheSupported) ShaderCache::prepare(program);
+        glLinkProgram(program);
+        bool linked = checkCompileErrors(program, "PROGRAM");
 
+        glDetachShader(program, vertexShader);
+        glDetachShader(program, fragmentShader);
         glDeleteShader(vertexShader);
         glDeleteShader(fragmentShader);
-    }
 
-    void use() {
-        glUseProgram(ID);
+        if (linked && cacheSupported) ShaderCache::store(program, key, ShaderCache::pathKey(vertexPath, fragmentPath));
+        return program;
     }
 
-    void setInt(const std::string& name, int value) const {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
-    }
+    // liste des uniformes et blocs actifs apres l'edition de liens
+    void reflect() {
+        uniforms.clear();
+        blocks.clear();
 
-    void setMat4(const std::string &name, const glm::mat4 &mat) const {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::string name(std::max(maxLength, 1), '\0');
+        for (GLint i = 0; i < count; i++) {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(ID, static_cast<GLuint>(i), maxLength, &length, &size, &type, &name[0]);
+            std::string uniformName(name.c_str(), length);
+            GLint location = glGetUniformLocation(ID, uniformName.c_str());
+            if (location < 0) continue; // membre d'un bloc
+            addUniform(uniformName, location);
+            // tableau : "nom[0]" est aussi accessible par "nom"
+            if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+                addUniform(uniformName.substr(0, uniformName.size() - 3), location);
+        }
+
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+        name.assign(std::max(maxLength, 1), '\0');
+        for (GLint i = 0; i < count; i++) {
+            GLsizei length = 0;
+            glGetActiveUniformBlockName(ID, static_cast<GLuint>(i), maxLength, &length, &name[0]);
+            blocks[hash(std::string(name.c_str(), length).c_str())] = static_cast<GLuint>(i);
+        }
     }
-    
-    void setVec3(const std::string &name, const glm::vec3 &value) const {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &value[0]);
+
+    void addUniform(const std::string& name, GLint location) {
+        auto result = uniforms.emplace(hash(name.c_str()), location);
+        if (!result.second && result.first->second != location)
+            std::cerr << "Collision de hash pour l'uniforme " << name << std::endl;
     }
 
-private:
-    void checkCompileErrors(unsigned int shader, const std::string& type) {
+    bool checkCompileErrors(unsigned int shader, const std::string& type) {
         int success;
         char infoLog[1024];
         if (type != "PROGRAM") {
@@ -115,6 +309,7 @@ private:
                 std::cerr << "PROGRAM LINKING FAILED\n" << infoLog << std::endl;
             }
         }
+        return success != 0;
     }
 };
 
@@ -0,0 +1,183 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <glad.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Hash.h"
+#include "MappedFile.h"
+
+// programmes lies (glGetProgramBinary) ranges dans shadercache/<cle>.progbin
+// cle = hash des sources + chaine du pilote : un changement de shader ou de pilote
+// donne un autre fichier ; l'ancien binaire de la meme paire de fichiers est supprime
+// a l'ecriture du nouveau (sinon chaque edition a chaud en laisserait un)
+// disposition : en-tete | binaire du pilote
+class ShaderCache {
+public:
+    static const uint32_t Version = 2;
+
+    struct Header {
+        char magic[4];          // "EYSB"
+        uint32_t version;
+        uint32_t binaryFormat;  // format renvoye par glGetProgramBinary
+        uint32_t binarySize;
+        uint64_t key;           // doit correspondre au nom du fichier
+        uint64_t pathKey;       // hash des chemins vertex + fragment (voir pathKey())
+    };
+
+    // glGetProgramBinary disponible (GL 4.1 ou ARB_get_program_binary) avec au moins un format
+    static bool supported() {
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+        if (!glGetProgramBinary || !glProgramBinary) return false; // pointeurs glad non charges
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+#else
+        return false;
+#endif
+    }
+
+    static std::string driverString() {
+        std::string driver;
+        const GLenum names[3] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+        for (GLenum name : names) {
+            const char* value = reinterpret_cast<const char*>(glGetString(name));
+            driver += value ? value : "?";
+            driver += '|';
+        }
+        return driver;
+    }
+
+    static uint64_t key(const std::string& vertexCode, const std::string& fragmentCode, const std::string& driver) {
+        std::string all = vertexCode + '\0' + fragmentCode + '\0' + driver;
+        return hashBytes(all.data(), all.size());
+    }
+
+    // identifie la paire de fichiers sources, quel que soit leur contenu
+    static uint64_t pathKey(const std::string& vertexPath, const std::string& fragmentPath) {
+        std::string both = vertexPath + '\0' + fragmentPath;
+        return hashBytes(both.data(), both.size());
+    }
+
+    static std::string cachePath(uint64_t key) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+        return std::string(Directory) + "/" + name + ".progbin";
+    }
+
+    // a appeler avant glLinkProgram pour pouvoir relire le binaire ensuite (si supported())
+    static void prepare(GLuint program) {
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#else
+        (void)program;
+#endif
+    }
+
+    // charge le binaire dans program ; faux si absent ou refuse par le pilote (on recompile alors)
+    static bool load(GLuint program, uint64_t key) {
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+        std::string path = cachePath(key);
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec)) return false;
+        MappedFile file;
+        if (!file.open(path) || file.size() < sizeof(Header)) return false;
+        Header header;
+        std::memcpy(&header, file.data(), sizeof(Header));
+        if (std::memcmp(header.magic, "EYSB", 4) != 0 || header.version != Version || header.key != key ||
+            sizeof(Header) + header.binarySize > file.size()) {
+            std::cerr << "Cache shader " << path << " : fichier invalide" << std::endl;
+            return false;
+        }
+        glProgramBinary(program, header.binaryFormat, file.data() + sizeof(Header), static_cast<GLsizei>(header.binarySize));
+        GLint linked = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        return linked != 0; // le pilote peut refuser un binaire d'une autre version
+#else
+        (void)program;
+        (void)key;
+        return false;
+#endif
+    }
+
+    // ecrit le binaire d'un programme lie (fichier temporaire puis renommage),
+    // puis supprime les binaires precedents de la meme paire de fichiers (pathKey)
+    static bool store(GLuint program, uint64_t key, uint64_t pathKey) {
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+        GLint size = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+        if (size <= 0) return false;
+        std::vector<char> binary(size);
+        GLenum format = 0;
+        GLsizei written = 0;
+        glGetProgramBinary(program, size, &written, &format, binary.data());
+        if (written <= 0) return false;
+
+        Header header = {};
+        std::memcpy(header.magic, "EYSB", 4);
+        header.version = Version;
+        header.binaryFormat = format;
+        header.binarySize = static_cast<uint32_t>(written);
+        header.key = key;
+        header.pathKey = pathKey;
+
+        std::error_code ec;
+        std::filesystem::create_directories(Directory, ec);
+        std::string path = cachePath(key);
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                std::cerr << "Cache shader : impossible d'ecrire " << tmpPath << std::endl;
+                return false;
+            }
+            out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+            out.write(binary.data(), written);
+            if (!out) return false;
+        }
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec) {
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+        removeSuperseded(key, pathKey);
+        return true;
+#else
+        (void)program;
+        (void)key;
+        (void)pathKey;
+        return false;
+#endif
+    }
+
+private:
+    // binaires de la meme paire de fichiers avec une autre cle (anciennes versions des sources),
+    // et ceux d'un ancien format, qui ne seront plus jamais relus
+    static void removeSuperseded(uint64_t key, uint64_t pathKey) {
+        std::error_code ec;
+        std::vector<std::filesystem::path> superseded;
+        for (std::filesystem::directory_iterator it(Directory, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->path().extension() != ".progbin") continue;
+            Header header;
+            std::ifstream in(it->path(), std::ios::binary);
+            if (!in.read(reinterpret_cast<char*>(&header), sizeof(Header))) continue;
+            if (std::memcmp(header.magic, "EYSB", 4) != 0) continue;
+            if (header.version != Version || (header.pathKey == pathKey && header.key != key)) {
+                superseded.push_back(it->path());
+            }
+        }
+        for (const std::filesystem::path& path : superseded) {
+            if (std::filesystem::remove(path, ec)) std::cout << "Cache shader : " << path.string() << " remplace, supprime" << std::endl;
+        }
+    }
+
+    static constexpr const char* Directory = "shadercache";
+};
+
+#endif
@@ -0,0 +1,249 @@
+#ifndef TEXTURE_ARRAY_H
+#define TEXTURE_ARRAY_H
+
+#include <glad.h>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include "TextureCompress.h"
+
+// toutes les textures de materiau dans un seul GL_TEXTURE_2D_ARRAY :
+// une couche par texture, meme taille pour toutes (les images sont reechantillonnees)
+// le shader choisit la couche par objet ou par instance, donc plus de glBindTexture
+// entre deux draws et des objets de textures differentes dans un meme appel instancie
+// GL_REPEAT reste valable dans chaque couche (contrairement a un atlas)
+// RGBA8 par defaut, ou BC1/BC3/BC7 : les couches viennent alors telles quelles des KTX
+// (meme format et meme taille pour toutes, les blocs ne se reechantillonnent pas)
+class TextureArray {
+public:
+    TextureArray(int layerWidth = 1024, int layerHeight = 1024, GLenum internalFormat = GL_RGBA8)
+        : width(layerWidth), height(layerHeight), format(internalFormat) {
+        isCompressed = TextureCompress::formatFromGL(format, blockFormat);
+        int size = std::max(width, height);
+        while (size > 0) {
+            levels++;
+            size >>= 1;
+        }
+    }
+
+    ~TextureArray() { release(); }
+
+    TextureArray(const TextureArray&) = delete;
+    TextureArray& operator=(const TextureArray&) = delete;
+
+    // a appeler une fois le contexte GL cree ; initialCapacity = nb de couches prevues
+    // (le tableau double ensuite a la demande)
+    void init(int initialCapacity = 1) {
+        glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+        capacity = std::max(1, std::min(initialCapacity, static_cast<int>(maxLayers)));
+        texture = allocate(capacity);
+        std::cout << "Tableau de textures : " << capacity << " couches " << width << "x" << height
+                  << ", " << levels << " mips" << (isCompressed ? " (compresse)" : "") << std::endl;
+    }
+
+    // reserve une couche grise en attendant son image ; -1 si la limite du pilote est atteinte
+    int addLayer() {
+        if (layers >= capacity) {
+            if (capacity >= maxLayers) {
+                std::cerr << "Tableau de textures plein (" << capacity << " couches)" << std::endl;
+                return -1;
+            }
+            grow(std::min(capacity * 2, static_cast<int>(maxLayers)));
+        }
+        int layer = layers++;
+        clearLayer(layer);
+        return layer;
+    }
+
+    void bind() const { glBindTexture(GL_TEXTURE_2D_ARRAY, texture); }
+
+    GLuint id() const { return texture; }
+    GLenum internalFormat() const { return format; }
+    bool compressed() const { return isCompressed; }
+
+    // le KTX peut remplir une couche : meme format, meme taille, chaine de mips complete
+    bool accepts(const TextureCompress::KtxView& ktx) const {
+        return isCompressed && ktx.glInternalFormat == format && ktx.width == width && ktx.height == height &&
+               static_cast<int>(ktx.levels.size()) >= levels;
+    }
+    int layerWidth() const { return width; }
+    int layerHeight() const { return height; }
+    int levelCount() const { return levels; }
+    int layerCount() const { return layers; }
+    int levelWidth(int level) const { return std::max(1, width >> level); }
+    int levelHeight(int level) const { return std::max(1, height >> level); }
+
+    void release() {
+        if (texture) glDeleteTextures(1, &texture);
+        if (clearFramebuffer) glDeleteFramebuffers(1, &clearFramebuffer);
+        if (greyBlocks) glDeleteBuffers(1, &greyBlocks);
+        texture = 0;
+        clearFramebuffer = 0;
+        greyBlocks = 0;
+        layers = 0;
+        capacity = 0;
+    }
+
+    // ---- preparation CPU (threads workers) ----
+
+    // mips d'une couche a partir d'une image quelconque : moitiés successives (filtre boite)
+    // tant que l'image fait plus du double de la couche, puis bilineaire jusqu'a la taille exacte
+    std::vector<TextureImage> prepareLayer(const TextureImage& source) const {
+        TextureImage image = source;
+        while (image.width >= 2 * width && image.height >= 2 * height)
+            image = TextureCompress::downsampleBox(image);
+        if (image.width != width || image.height != height) image = resample(image, width, height);
+        return TextureCompress::buildMipChain(image, MipFilter::Box);
+    }
+
+    // reechantillonnage bilineaire (bords repetes : les textures de materiau se repetent)
+    static TextureImage resample(const TextureImage& src, int w, int h) {
+        TextureImage dst(w, h);
+        const float sx = static_cast<float>(src.width) / w, sy = static_cast<float>(src.height) / h;
+        for (int y = 0; y < h; y++) {
+            float fy = (y + 0.5f) * sy - 0.5f;
+            int y0 = static_cast<int>(std::floor(fy));
+            float ty = fy - y0;
+            int ya = wrap(y0, src.height), yb = wrap(y0 + 1, src.height);
+            for (int x = 0; x < w; x++) {
+                float fx = (x + 0.5f) * sx - 0.5f;
+                int x0 = static_cast<int>(std::floor(fx));
+                float tx = fx - x0;
+                int xa = wrap(x0, src.width), xb = wrap(x0 + 1, src.width);
+                for (int c = 0; c < 4; c++) {
+                    float top = src.pixel(xa, ya)[c] * (1.0f - tx) + src.pixel(xb, ya)[c] * tx;
+                    float bottom = src.pixel(xa, yb)[c] * (1.0f - tx) + src.pixel(xb, yb)[c] * tx;
+                    dst.pixel(x, y)[c] = static_cast<uint8_t>(std::min(255.0f, top * (1.0f - ty) + bottom * ty + 0.5f));
+                }
+            }
+        }
+        return dst;
+    }
+
+private:
+    int width, height;
+    GLenum format;
+    bool isCompressed = false;
+    BlockFormat blockFormat = BlockFormat::BC1;
+    int capacity = 0;
+    int levels = 0;
+    int layers = 0;
+    GLint maxLayers = 256;
+    GLuint texture = 0;
+    GLuint clearFramebuffer = 0;
+    GLuint greyBlocks = 0;   // buffer de blocs gris (tableaux compresses)
+
+    // octets d'une couche au niveau level
+    size_t levelBytes(int level) const {
+        if (isCompressed) return TextureCompress::levelSize(blockFormat, levelWidth(level), levelHeight(level));
+        return static_cast<size_t>(levelWidth(level)) * levelHeight(level) * 4;
+    }
+
+    GLuint allocate(int layerCount) const {
+        GLuint id = 0;
+        glGenTextures(1, &id);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, id);
+        for (int level = 0; level < levels; level++) {
+            if (isCompressed) {
+                glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, format, levelWidth(level), levelHeight(level), layerCount, 0,
+                                       static_cast<GLsizei>(levelBytes(level) * layerCount), nullptr);
+            } else {
+                glTexImage3D(GL_TEXTURE_2D_ARRAY, level, format, levelWidth(level), levelHeight(level), layerCount, 0,
+                             GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            }
+        }
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1);
+        return id;
+    }
+
+    // nouveau tableau plus grand ; les couches existantes sont copiees par le GPU
+    // (lecture dans un buffer puis envoi depuis ce buffer, sans passer par la memoire CPU)
+    // l'identifiant change : id() est relu a chaque frame par le rendu
+    void grow(int newCapacity) {
+        GLuint larger = allocate(newCapacity);
+        GLuint staging = 0;
+        glGenBuffers(1, &staging);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        for (int level = 0; level < levels; level++) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, staging);
+            glBufferData(GL_PIXEL_PACK_BUFFER, levelBytes(level) * capacity, nullptr, GL_STREAM_COPY);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+            if (isCompressed) glGetCompressedTexImage(GL_TEXTURE_2D_ARRAY, level, nullptr);
+            else glGetTexImage(GL_TEXTURE_2D_ARRAY, level, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, larger);
+            if (isCompressed) {
+                glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, levelWidth(level), levelHeight(level), capacity,
+                                          format, static_cast<GLsizei>(levelBytes(level) * capacity), nullptr);
+            } else {
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, levelWidth(level), levelHeight(level), capacity,
+                                GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            }
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &staging);
+        glDeleteTextures(1, &texture);
+        texture = larger;
+        std::cout << "Tableau de textures : " << capacity << " -> " << newCapacity << " couches" << std::endl;
+        capacity = newCapacity;
+    }
+
+    // gris moyen sur tous les mips de la couche : effacement par le GPU, aucune donnee envoyee
+    // (un format compresse ne peut pas etre cible de rendu : copie depuis un buffer de blocs gris)
+    void clearLayer(int layer) {
+        if (isCompressed) {
+            if (!greyBlocks) greyBlocks = makeGreyBlocks(levelBytes(0));
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, greyBlocks);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+            for (int level = 0; level < levels; level++) {
+                glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, levelWidth(level), levelHeight(level), 1,
+                                          format, static_cast<GLsizei>(levelBytes(level)), nullptr);
+            }
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return;
+        }
+        GLint previous = 0;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous);
+        if (!clearFramebuffer) glGenFramebuffers(1, &clearFramebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, clearFramebuffer);
+        const GLfloat grey[4] = { 0.5f, 0.5f, 0.5f, 1.0f };
+        for (int level = 0; level < levels; level++) {
+            glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, texture, level, layer);
+            glClearBufferfv(GL_COLOR, 0, grey);
+        }
+        glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, 0, 0, 0);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(previous));
+    }
+
+    // buffer de bytes octets rempli d'un meme bloc gris : un bloc envoye, puis doublements
+    // par glCopyBufferSubData (le remplissage reste sur le GPU)
+    GLuint makeGreyBlocks(size_t bytes) const {
+        TextureImage grey(4, 4);
+        std::fill(grey.rgba.begin(), grey.rgba.end(), 128);
+        for (size_t i = 3; i < grey.rgba.size(); i += 4) grey.rgba[i] = 255;
+        CompressedLevel block = TextureCompress::compress(grey, blockFormat);
+
+        GLuint buffer = 0;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, bytes, nullptr, GL_STATIC_COPY);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, 0, block.data.size(), block.data.data());
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        for (size_t filled = block.data.size(); filled < bytes; filled *= 2)
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, filled, std::min(filled, bytes - filled));
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        return buffer;
+    }
+
+    static int wrap(int v, int size) { return ((v % size) + size) % size; }
+};
+
+#endif
@@ -0,0 +1,750 @@
+#ifndef TEXTURE_COMPRESS_H
+#define TEXTURE_COMPRESS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TEXTURE_COMPRESS_SSE 1
+#endif
+
+// compression de textures hors ligne : mips sur CPU, blocs BC1/BC3/BC7 et conteneur KTX 1.1
+// aucune dependance a OpenGL (utilise par tools/texcompress.cpp et par le chargeur de textures)
+
+// image RGBA8 en memoire
+struct TextureImage {
+    int width = 0, height = 0;
+    std::vector<uint8_t> rgba;
+
+    TextureImage() = default;
+    TextureImage(int w, int h) : width(w), height(h), rgba(static_cast<size_t>(w) * h * 4) {}
+
+    uint8_t* pixel(int x, int y) { return &rgba[(static_cast<size_t>(y) * width + x) * 4]; }
+    const uint8_t* pixel(int x, int y) const { return &rgba[(static_cast<size_t>(y) * width + x) * 4]; }
+};
+
+enum class BlockFormat {
+    BC1,   // RGB + alpha 1 bit, 8 octets par bloc 4x4
+    BC3,   // RGB + alpha interpole, 16 octets
+    BC7    // RGBA haute qualite (mode 6 uniquement), 16 octets
+};
+
+enum class MipFilter {
+    Box,
+    Kaiser
+};
+
+// valeurs GL des formats (pour le conteneur KTX et glCompressedTexImage2D)
+namespace KtxFormat {
+    const uint32_t RGBA = 0x1908;
+    const uint32_t CompressedBC1 = 0x83F1;   // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+    const uint32_t CompressedBC3 = 0x83F3;   // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+    const uint32_t CompressedBC7 = 0x8E8C;   // GL_COMPRESSED_RGBA_BPTC_UNORM
+}
+
+// niveau de mip compresse
+struct CompressedLevel {
+    int width = 0, height = 0;
+    std::vector<uint8_t> data;
+};
+
+// PSNR en dB entre deux images de meme taille
+struct TextureMetrics {
+    double psnrRGB = 0.0;
+    double psnrAlpha = 0.0;
+};
+
+class TextureCompress {
+public:
+    static size_t blockBytes(BlockFormat format) { return format == BlockFormat::BC1 ? 8 : 16; }
+
+    static uint32_t glFormat(BlockFormat format) {
+        switch (format) {
+        case BlockFormat::BC1: return KtxFormat::CompressedBC1;
+        case BlockFormat::BC3: return KtxFormat::CompressedBC3;
+        default: return KtxFormat::CompressedBC7;
+        }
+    }
+
+    static bool formatFromGL(uint32_t glInternalFormat, BlockFormat& format) {
+        if (glInternalFormat == KtxFormat::CompressedBC1) format = BlockFormat::BC1;
+        else if (glInternalFormat == KtxFormat::CompressedBC3) format = BlockFormat::BC3;
+        else if (glInternalFormat == KtxFormat::CompressedBC7) format = BlockFormat::BC7;
+        else return false;
+        return true;
+    }
+
+    static size_t levelSize(BlockFormat format, int width, int height) {
+        return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+    }
+
+    // ---------------------------------------------------------------- mips
+
+    // chaine complete jusqu'a 1x1 (le niveau 0 est l'image d'origine)
+    static std::vector<TextureImage> buildMipChain(const TextureImage& base, MipFilter filter) {
+        std::vector<TextureImage> chain;
+        chain.push_back(base);
+        while (chain.back().width > 1 || chain.back().height > 1) {
+            const TextureImage& src = chain.back();
+            chain.push_back(filter == MipFilter::Box ? downsampleBox(src) : downsampleKaiser(src));
+        }
+        return chain;
+    }
+
+    // moyenne 2x2 ; SSE2 : deux pixels de sortie par iteration
+    static TextureImage downsampleBox(const TextureImage& src) {
+        TextureImage dst(std::max(1, src.width / 2), std::max(1, src.height / 2));
+        for (int y = 0; y < dst.height; y++) {
+            const int y0 = std::min(2 * y, src.height - 1), y1 = std::min(2 * y + 1, src.height - 1);
+            int x = 0;
+#ifdef TEXTURE_COMPRESS_SSE
+            if (src.width >= 4) {
+                const __m128i zero = _mm_setzero_si128(), two = _mm_set1_epi16(2);
+                for (; 2 * x + 3 < src.width && x + 1 < dst.width; x += 2) {
+                    __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src.pixel(2 * x, y0)));
+                    __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src.pixel(2 * x, y1)));
+                    // somme verticale en 16 bits : lo = pixels 0 et 1, hi = pixels 2 et 3
+                    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, zero), _mm_unpacklo_epi8(r1, zero));
+                    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, zero), _mm_unpackhi_epi8(r1, zero));
+                    // somme horizontale : (p0 + p1, p2 + p3)
+                    __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+                    sum = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst.pixel(x, y)), _mm_packus_epi16(sum, zero));
+                }
+            }
+#endif
+            for (; x < dst.width; x++) {
+                const int x0 = std::min(2 * x, src.width - 1), x1 = std::min(2 * x + 1, src.width - 1);
+                for (int c = 0; c < 4; c++) {
+                    int sum = src.pixel(x0, y0)[c] + src.pixel(x1, y0)[c] + src.pixel(x0, y1)[c] + src.pixel(x1, y1)[c];
+                    dst.pixel(x, y)[c] = static_cast<uint8_t>((sum + 2) >> 2);
+                }
+            }
+        }
+        return dst;
+    }
+
+    // sinc fenetre par Kaiser, separable, 6 echantillons par axe ; un pixel RGBA = 4 floats (un registre SSE)
+    static TextureImage downsampleKaiser(const TextureImage& src) {
+        const int dw = std::max(1, src.width / 2), dh = std::max(1, src.height / 2);
+        const int taps = 6;
+        float weights[taps];
+        kaiserWeights(weights, taps);
+
+        // passe horizontale (seulement si la largeur diminue)
+        std::vector<float> tmp(static_cast<size_t>(dw) * src.height * 4);
+        for (int y = 0; y < src.height; y++) {
+            for (int x = 0; x < dw; x++) {
+                float acc[4] = { 0, 0, 0, 0 };
+                if (src.width == 1) {
+                    for (int c = 0; c < 4; c++) acc[c] = src.pixel(0, y)[c];
+                } else {
+                    accumulate(acc, weights, taps, [&](int k) { return src.pixel(clampi(2 * x - 2 + k, 0, src.width - 1), y); });
+                }
+                std::memcpy(&tmp[(static_cast<size_t>(y) * dw + x) * 4], acc, sizeof(acc));
+            }
+        }
+
+        // passe verticale
+        TextureImage dst(dw, dh);
+        for (int y = 0; y < dh; y++) {
+            for (int x = 0; x < dw; x++) {
+                float acc[4] = { 0, 0, 0, 0 };
+                if (src.height == 1) {
+                    std::memcpy(acc, &tmp[static_cast<size_t>(x) * 4], sizeof(acc));
+                } else {
+                    for (int k = 0; k < taps; k++) {
+                        const float* p = &tmp[(static_cast<size_t>(clampi(2 * y - 2 + k, 0, src.height - 1)) * dw + x) * 4];
+                        madd(acc, p, weights[k]);
+                    }
+                }
+                for (int c = 0; c < 4; c++) dst.pixel(x, y)[c] = static_cast<uint8_t>(clampi(static_cast<int>(acc[c] + 0.5f), 0, 255));
+            }
+        }
+        return dst;
+    }
+
+    // ---------------------------------------------------------------- compression
+
+    static CompressedLevel compress(const TextureImage& image, BlockFormat format) {
+        CompressedLevel level;
+        level.width = image.width;
+        level.height = image.height;
+        level.data.resize(levelSize(format, image.width, image.height));
+        const int bw = (image.width + 3) / 4, bh = (image.height + 3) / 4;
+        uint8_t block[64];
+        for (int by = 0; by < bh; by++) {
+            for (int bx = 0; bx < bw; bx++) {
+                fetchBlock(image, bx, by, block);
+                uint8_t* out = &level.data[(static_cast<size_t>(by) * bw + bx) * blockBytes(format)];
+                switch (format) {
+                case BlockFormat::BC1: encodeBC1(block, out); break;
+                case BlockFormat::BC3: encodeBC3(block, out); break;
+                case BlockFormat::BC7: encodeBC7(block, out); break;
+                }
+            }
+        }
+        return level;
+    }
+
+    static TextureImage decompress(const uint8_t* data, int width, int height, BlockFormat format) {
+        TextureImage image(width, height);
+        const int bw = (width + 3) / 4, bh = (height + 3) / 4;
+        uint8_t block[64];
+        for (int by = 0; by < bh; by++) {
+            for (int bx = 0; bx < bw; bx++) {
+                const uint8_t* in = data + (static_cast<size_t>(by) * bw + bx) * blockBytes(format);
+                switch (format) {
+                case BlockFormat::BC1: decodeBC1(in, block, false); break;
+                case BlockFormat::BC3: decodeBC3(in, block); break;
+                case BlockFormat::BC7: decodeBC7(in, block); break;
+                }
+                for (int y = 0; y < 4 && by * 4 + y < height; y++)
+                    for (int x = 0; x < 4 && bx * 4 + x < width; x++)
+                        std::memcpy(image.pixel(bx * 4 + x, by * 4 + y), &block[(y * 4 + x) * 4], 4);
+            }
+        }
+        return image;
+    }
+
+    static TextureMetrics measure(const TextureImage& a, const TextureImage& b) {
+        double rgb = 0.0, alpha = 0.0;
+        const size_t pixels = static_cast<size_t>(a.width) * a.height;
+        for (size_t i = 0; i < pixels; i++) {
+            for (int c = 0; c < 3; c++) {
+                double d = static_cast<double>(a.rgba[i * 4 + c]) - b.rgba[i * 4 + c];
+                rgb += d * d;
+            }
+            double d = static_cast<double>(a.rgba[i * 4 + 3]) - b.rgba[i * 4 + 3];
+            alpha += d * d;
+        }
+        TextureMetrics m;
+        m.psnrRGB = psnr(rgb / (pixels * 3.0));
+        m.psnrAlpha = psnr(alpha / pixels);
+        return m;
+    }
+
+    // ---------------------------------------------------------------- conteneur KTX 1.1
+
+    static bool writeKTX(const std::string& path, BlockFormat format, const std::vector<CompressedLevel>& levels) {
+        if (levels.empty()) return false;
+        FILE* f = std::fopen(path.c_str(), "wb");
+        if (!f) return false;
+        KtxHeader header;
+        std::memcpy(header.identifier, KtxIdentifier, 12);
+        header.endianness = 0x04030201;
+        header.glType = 0;
+        header.glTypeSize = 1;
+        header.glFormat = 0;
+        header.glInternalFormat = glFormat(format);
+        header.glBaseInternalFormat = KtxFormat::RGBA;
+        header.pixelWidth = static_cast<uint32_t>(levels[0].width);
+        header.pixelHeight = static_cast<uint32_t>(levels[0].height);
+        header.pixelDepth = 0;
+        header.numberOfArrayElements = 0;
+        header.numberOfFaces = 1;
+        header.numberOfMipmapLevels = static_cast<uint32_t>(levels.size());
+        header.bytesOfKeyValueData = 0;
+        bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+        for (const CompressedLevel& level : levels) {
+            uint32_t size = static_cast<uint32_t>(level.data.size());
+            ok = ok && std::fwrite(&size, 4, 1, f) == 1;
+            ok = ok && std::fwrite(level.data.data(), 1, level.data.size(), f) == level.data.size();
+            // taille de bloc multiple de 4 : pas de padding de niveau
+        }
+        return std::fclose(f) == 0 && ok;
+    }
+
+    // niveau pointant dans un fichier projete
+    struct CompressedLevelView {
+        int width = 0, height = 0;
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+    };
+
+    // vue sur un KTX projete en memoire (les niveaux pointent dans le fichier)
+    struct KtxView {
+        BlockFormat format = BlockFormat::BC1;
+        uint32_t glInternalFormat = 0;
+        int width = 0, height = 0;
+        std::vector<CompressedLevelView> levels;
+    };
+
+    static bool readKTX(const MappedFile& file, KtxView& view) {
+        if (!file.isOpen() || file.size() < sizeof(KtxHeader)) return false;
+        KtxHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.identifier, KtxIdentifier, 12) != 0 || header.endianness != 0x04030201) return false;
+        if (!formatFromGL(header.glInternalFormat, view.format)) return false;
+        if (header.numberOfFaces != 1 || header.numberOfArrayElements != 0 || header.pixelDepth != 0) return false;
+
+        view.glInternalFormat = header.glInternalFormat;
+        view.width = static_cast<int>(header.pixelWidth);
+        view.height = static_cast<int>(header.pixelHeight);
+        view.levels.clear();
+
+        size_t offset = sizeof(header) + header.bytesOfKeyValueData;
+        int w = view.width, h = view.height;
+        for (uint32_t i = 0; i < std::max(1u, header.numberOfMipmapLevels); i++) {
+            if (offset + 4 > file.size()) return false;
+            uint32_t size;
+            std::memcpy(&size, file.data() + offset, 4);
+            offset += 4;
+            if (offset + size > file.size() || size != levelSize(view.format, w, h)) return false;
+            CompressedLevelView level;
+            level.width = w;
+            level.height = h;
+            level.data = reinterpret_cast<const uint8_t*>(file.data()) + offset;
+            level.size = size;
+            view.levels.push_back(level);
+            offset += (size + 3) & ~static_cast<size_t>(3);
+            w = std::max(1, w / 2);
+            h = std::max(1, h / 2);
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------- blocs
+
+    // BC1 : deux couleurs 565 sur l'axe principal, 4 couleurs interpolees
+    static void encodeBC1(const uint8_t* block, uint8_t* out) {
+        float mean[3], axis[3];
+        principalAxis(block, 3, mean, axis);
+
+        float tMin = 1e30f, tMax = -1e30f;
+        for (int i = 0; i < 16; i++) {
+            float t = 0;
+            for (int c = 0; c < 3; c++) t += (block[i * 4 + c] - mean[c]) * axis[c];
+            tMin = std::min(tMin, t);
+            tMax = std::max(tMax, t);
+        }
+        // leger retrait vers l'interieur : les extremes sont mieux servis par les couleurs interpolees
+        float inset = (tMax - tMin) / 16.0f;
+        tMin += inset;
+        tMax -= inset;
+
+        float e0[3], e1[3];
+        for (int c = 0; c < 3; c++) {
+            e0[c] = mean[c] + axis[c] * tMax;
+            e1[c] = mean[c] + axis[c] * tMin;
+        }
+        uint16_t c0 = to565(e0), c1 = to565(e1);
+        uint8_t indices[16];
+        chooseBC1Indices(block, c0, c1, indices);
+
+        // une passe de moindres carres sur les extremites avec les indices choisis
+        refineBC1(block, indices, c0, c1);
+        chooseBC1Indices(block, c0, c1, indices);
+
+        // mode 4 couleurs : c0 > c1 obligatoire
+        if (c0 < c1) {
+            std::swap(c0, c1);
+            for (uint8_t& idx : indices) idx ^= 1;   // 0<->1, 2<->3
+        }
+        if (c0 == c1) std::fill(indices, indices + 16, 0);
+
+        out[0] = c0 & 0xFF; out[1] = c0 >> 8;
+        out[2] = c1 & 0xFF; out[3] = c1 >> 8;
+        uint32_t bits = 0;
+        for (int i = 0; i < 16; i++) bits |= static_cast<uint32_t>(indices[i]) << (2 * i);
+        std::memcpy(out + 4, &bits, 4);
+    }
+
+    static void decodeBC1(const uint8_t* in, uint8_t* block, bool forBC3) {
+        uint16_t c0 = in[0] | (in[1] << 8), c1 = in[2] | (in[3] << 8);
+        uint8_t palette[4][4];
+        from565(c0, palette[0]);
+        from565(c1, palette[1]);
+        if (c0 > c1 || forBC3) {
+            for (int c = 0; c < 3; c++) {
+                palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c] + 1) / 3);
+                palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+            }
+            palette[2][3] = palette[3][3] = 255;
+        } else {
+            for (int c = 0; c < 3; c++) {
+                palette[2][c] = static_cast<uint8_t>((palette[0][c] + palette[1][c]) / 2);
+                palette[3][c] = 0;
+            }
+            palette[2][3] = 255;
+            palette[3][3] = 0;
+        }
+        uint32_t bits;
+        std::memcpy(&bits, in + 4, 4);
+        for (int i = 0; i < 16; i++) std::memcpy(&block[i * 4], palette[(bits >> (2 * i)) & 3], 4);
+    }
+
+    // BC3 : bloc alpha (8 niveaux interpoles) + bloc couleur BC1
+    static void encodeBC3(const uint8_t* block, uint8_t* out) {
+        uint8_t a0 = 0, a1 = 255;
+        for (int i = 0; i < 16; i++) {
+            a0 = std::max(a0, block[i * 4 + 3]);
+            a1 = std::min(a1, block[i * 4 + 3]);
+        }
+        out[0] = a0;
+        out[1] = a1;
+        uint64_t bits = 0;
+        if (a0 > a1) {
+            uint8_t palette[8];
+            alphaPalette(a0, a1, palette);
+            for (int i = 0; i < 16; i++) {
+                int best = 0, bestErr = 1 << 30;
+                for (int k = 0; k < 8; k++) {
+                    int err = std::abs(palette[k] - block[i * 4 + 3]);
+                    if (err < bestErr) { bestErr = err; best = k; }
+                }
+                bits |= static_cast<uint64_t>(best) << (3 * i);
+            }
+        }
+        for (int i = 0; i < 6; i++) out[2 + i] = static_cast<uint8_t>(bits >> (8 * i));
+        encodeBC1(block, out + 8);
+    }
+
+    static void decodeBC3(const uint8_t* in, uint8_t* block) {
+        decodeBC1(in + 8, block, true);
+        uint8_t palette[8];
+        alphaPalette(in[0], in[1], palette);
+        uint64_t bits = 0;
+        for (int i = 0; i < 6; i++) bits |= static_cast<uint64_t>(in[2 + i]) << (8 * i);
+        for (int i = 0; i < 16; i++) block[i * 4 + 3] = palette[(bits >> (3 * i)) & 7];
+    }
+
+    // BC7 mode 6 : un sous-ensemble, extremites RGBA 7 bits + bit p, indices 4 bits
+    static void encodeBC7(const uint8_t* block, uint8_t* out) {
+        float mean[4], axis[4];
+        principalAxis(block, 4, mean, axis);
+        float tMin = 1e30f, tMax = -1e30f;
+        for (int i = 0; i < 16; i++) {
+            float t = 0;
+            for (int c = 0; c < 4; c++) t += (block[i * 4 + c] - mean[c]) * axis[c];
+            tMin = std::min(tMin, t);
+            tMax = std::max(tMax, t);
+        }
+
+        float e0[4], e1[4];
+        for (int c = 0; c < 4; c++) {
+            e0[c] = mean[c] + axis[c] * tMin;
+            e1[c] = mean[c] + axis[c] * tMax;
+        }
+
+        // les 4 combinaisons de bits p : celle qui minimise l'erreur du bloc entier
+        // (un bloc uniforme peut melanger des canaux pairs et impairs)
+        int q0[4], q1[4], p0 = 0, p1 = 0;
+        uint8_t indices[16];
+        int bestErr = -1;
+        for (int combo = 0; combo < 4; combo++) {
+            int c0[4], c1[4], pb0 = combo & 1, pb1 = combo >> 1;
+            quantizeBC7Endpoint(e0, c0, pb0);
+            quantizeBC7Endpoint(e1, c1, pb1);
+            uint8_t candidate[16];
+            int err = chooseBC7Indices(block, c0, pb0, c1, pb1, candidate);
+            if (bestErr < 0 || err < bestErr) {
+                bestErr = err;
+                std::memcpy(q0, c0, sizeof(q0));
+                std::memcpy(q1, c1, sizeof(q1));
+                p0 = pb0;
+                p1 = pb1;
+                std::memcpy(indices, candidate, sizeof(indices));
+            }
+        }
+
+        // l'indice du pixel 0 est stocke sur 3 bits : son bit de poids fort doit etre nul
+        if (indices[0] & 8) {
+            for (int c = 0; c < 4; c++) std::swap(q0[c], q1[c]);
+            std::swap(p0, p1);
+            for (uint8_t& idx : indices) idx = static_cast<uint8_t>(15 - idx);
+        }
+
+        BitWriter w(out);
+        w.write(1 << 6, 7);   // mode 6
+        for (int c = 0; c < 4; c++) {
+            w.write(q0[c], 7);
+            w.write(q1[c], 7);
+        }
+        w.write(p0, 1);
+        w.write(p1, 1);
+        w.write(indices[0], 3);
+        for (int i = 1; i < 16; i++) w.write(indices[i], 4);
+    }
+
+    static void decodeBC7(const uint8_t* in, uint8_t* block) {
+        BitReader r(in);
+        if (r.read(7) != (1 << 6)) {
+            // autres modes non produits par l'encodeur : magenta
+            for (int i = 0; i < 16; i++) { block[i * 4] = 255; block[i * 4 + 1] = 0; block[i * 4 + 2] = 255; block[i * 4 + 3] = 255; }
+            return;
+        }
+        int q[2][4];
+        for (int c = 0; c < 4; c++) {
+            q[0][c] = r.read(7);
+            q[1][c] = r.read(7);
+        }
+        int p0 = r.read(1), p1 = r.read(1);
+        uint8_t ep[2][4];
+        for (int c = 0; c < 4; c++) {
+            ep[0][c] = static_cast<uint8_t>((q[0][c] << 1) | p0);
+            ep[1][c] = static_cast<uint8_t>((q[1][c] << 1) | p1);
+        }
+        for (int i = 0; i < 16; i++) {
+            int idx = r.read(i == 0 ? 3 : 4);
+            for (int c = 0; c < 4; c++) block[i * 4 + c] = bc7Interpolate(ep[0][c], ep[1][c], idx);
+        }
+    }
+
+private:
+    static constexpr const char* KtxIdentifier = "\xABKTX 11\xBB\r\n\x1A\n";
+
+#pragma pack(push, 1)
+    struct KtxHeader {
+        uint8_t identifier[12];
+        uint32_t endianness;
+        uint32_t glType;
+        uint32_t glTypeSize;
+        uint32_t glFormat;
+        uint32_t glInternalFormat;
+        uint32_t glBaseInternalFormat;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t numberOfArrayElements;
+        uint32_t numberOfFaces;
+        uint32_t numberOfMipmapLevels;
+        uint32_t bytesOfKeyValueData;
+    };
+#pragma pack(pop)
+
+    struct BitWriter {
+        uint8_t* out;
+        int pos = 0;
+        explicit BitWriter(uint8_t* o) : out(o) { std::memset(out, 0, 16); }
+        void write(int value, int bits) {
+            for (int i = 0; i < bits; i++, pos++)
+                if (value & (1 << i)) out[pos >> 3] |= static_cast<uint8_t>(1 << (pos & 7));
+        }
+    };
+
+    struct BitReader {
+        const uint8_t* in;
+        int pos = 0;
+        explicit BitReader(const uint8_t* i) : in(i) {}
+        int read(int bits) {
+            int value = 0;
+            for (int i = 0; i < bits; i++, pos++)
+                if (in[pos >> 3] & (1 << (pos & 7))) value |= 1 << i;
+            return value;
+        }
+    };
+
+    static int clampi(int v, int lo, int hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+    static double psnr(double mse) {
+        if (mse <= 0.0) return 99.0;
+        return 10.0 * std::log10(255.0 * 255.0 / mse);
+    }
+
+    // poids des 6 echantillons (decimation par 2, centre entre deux pixels source)
+    static void kaiserWeights(float* weights, int taps) {
+        const double pi = 3.14159265358979323846, alpha = 4.0, radius = taps / 2.0;
+        double sum = 0.0;
+        for (int k = 0; k < taps; k++) {
+            double x = (k + 0.5) - radius;             // distance au centre en pixels source
+            double s = x == 0.0 ? 1.0 : std::sin(pi * x / 2.0) / (pi * x / 2.0);
+            double r = x / radius;
+            double window = besselI0(alpha * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(alpha);
+            weights[k] = static_cast<float>(s * window);
+            sum += weights[k];
+        }
+        for (int k = 0; k < taps; k++) weights[k] = static_cast<float>(weights[k] / sum);
+    }
+
+    static double besselI0(double x) {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 20; k++) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    // acc += p * w sur 4 canaux
+    static void madd(float* acc, const float* p, float w) {
+#ifdef TEXTURE_COMPRESS_SSE
+        _mm_storeu_ps(acc, _mm_add_ps(_mm_loadu_ps(acc), _mm_mul_ps(_mm_loadu_ps(p), _mm_set1_ps(w))));
+#else
+        for (int c = 0; c < 4; c++) acc[c] += p[c] * w;
+#endif
+    }
+
+    template <typename Fetch>
+    static void accumulate(float* acc, const float* weights, int taps, Fetch fetch) {
+#ifdef TEXTURE_COMPRESS_SSE
+        __m128 sum = _mm_setzero_ps();
+        for (int k = 0; k < taps; k++) {
+            const uint8_t* p = fetch(k);
+            __m128i px = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(p));
+            px = _mm_unpacklo_epi16(_mm_unpacklo_epi8(px, _mm_setzero_si128()), _mm_setzero_si128());
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_cvtepi32_ps(px), _mm_set1_ps(weights[k])));
+        }
+        _mm_storeu_ps(acc, sum);
+#else
+        for (int k = 0; k < taps; k++) {
+            const uint8_t* p = fetch(k);
+            for (int c = 0; c < 4; c++) acc[c] += p[c] * weights[k];
+        }
+#endif
+    }
+
+    // bloc 4x4 RGBA, bords repetes
+    static void fetchBlock(const TextureImage& image, int bx, int by, uint8_t* block) {
+        for (int y = 0; y < 4; y++)
+            for (int x = 0; x < 4; x++)
+                std::memcpy(&block[(y * 4 + x) * 4],
+                            image.pixel(std::min(bx * 4 + x, image.width - 1), std::min(by * 4 + y, image.height - 1)), 4);
+    }
+
+    // moyenne et axe de plus grande variance (iteration de la puissance)
+    static void principalAxis(const uint8_t* block, int channels, float* mean, float* axis) {
+        for (int c = 0; c < channels; c++) {
+            mean[c] = 0;
+            for (int i = 0; i < 16; i++) mean[c] += block[i * 4 + c];
+            mean[c] /= 16.0f;
+        }
+        float cov[4][4] = {};
+        for (int i = 0; i < 16; i++)
+            for (int a = 0; a < channels; a++)
+                for (int b = 0; b < channels; b++)
+                    cov[a][b] += (block[i * 4 + a] - mean[a]) * (block[i * 4 + b] - mean[b]);
+
+        for (int c = 0; c < channels; c++) axis[c] = 1.0f;
+        for (int iter = 0; iter < 8; iter++) {
+            float next[4] = {};
+            for (int a = 0; a < channels; a++)
+                for (int b = 0; b < channels; b++) next[a] += cov[a][b] * axis[b];
+            float len = 0;
+            for (int c = 0; c < channels; c++) len += next[c] * next[c];
+            len = std::sqrt(len);
+            if (len < 1e-6f) break; // bloc uniforme
+            for (int c = 0; c < channels; c++) axis[c] = next[c] / len;
+        }
+        float len = 0;
+        for (int c = 0; c < channels; c++) len += axis[c] * axis[c];
+        len = std::sqrt(len);
+        for (int c = 0; c < channels; c++) axis[c] /= len;
+    }
+
+    static uint16_t to565(const float* rgb) {
+        int r = clampi(static_cast<int>(rgb[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+        int g = clampi(static_cast<int>(rgb[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+        int b = clampi(static_cast<int>(rgb[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    static void from565(uint16_t c, uint8_t* rgba) {
+        int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+        rgba[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+        rgba[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+        rgba[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+        rgba[3] = 255;
+    }
+
+    static void chooseBC1Indices(const uint8_t* block, uint16_t c0, uint16_t c1, uint8_t* indices) {
+        uint8_t palette[4][4];
+        from565(c0, palette[0]);
+        from565(c1, palette[1]);
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c] + 1) / 3);
+            palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+        }
+        for (int i = 0; i < 16; i++) {
+            int best = 0, bestErr = 1 << 30;
+            for (int k = 0; k < 4; k++) {
+                int err = 0;
+                for (int c = 0; c < 3; c++) {
+                    int d = palette[k][c] - block[i * 4 + c];
+                    err += d * d;
+                }
+                if (err < bestErr) { bestErr = err; best = k; }
+            }
+            indices[i] = static_cast<uint8_t>(best);
+        }
+    }
+
+    // extremites au sens des moindres carres pour des indices donnes
+    static void refineBC1(const uint8_t* block, const uint8_t* indices, uint16_t& c0, uint16_t& c1) {
+        static const float w0[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+        float aa = 0, ab = 0, bb = 0, ax[3] = {}, bx[3] = {};
+        for (int i = 0; i < 16; i++) {
+            float a = w0[indices[i]], b = 1.0f - a;
+            aa += a * a; ab += a * b; bb += b * b;
+            for (int c = 0; c < 3; c++) {
+                ax[c] += a * block[i * 4 + c];
+                bx[c] += b * block[i * 4 + c];
+            }
+        }
+        float det = aa * bb - ab * ab;
+        if (std::abs(det) < 1e-6f) return;
+        float e0[3], e1[3];
+        for (int c = 0; c < 3; c++) {
+            e0[c] = (ax[c] * bb - bx[c] * ab) / det;
+            e1[c] = (bx[c] * aa - ax[c] * ab) / det;
+        }
+        c0 = to565(e0);
+        c1 = to565(e1);
+    }
+
+    static void alphaPalette(uint8_t a0, uint8_t a1, uint8_t* palette) {
+        palette[0] = a0;
+        palette[1] = a1;
+        if (a0 > a1) {
+            for (int k = 1; k < 7; k++) palette[k + 1] = static_cast<uint8_t>(((7 - k) * a0 + k * a1 + 3) / 7);
+        } else {
+            for (int k = 1; k < 5; k++) palette[k + 1] = static_cast<uint8_t>(((5 - k) * a0 + k * a1 + 2) / 5);
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+    }
+
+    static uint8_t bc7Interpolate(int e0, int e1, int index) {
+        static const int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+        return static_cast<uint8_t>(((64 - weights[index]) * e0 + weights[index] * e1 + 32) >> 6);
+    }
+
+    // 7 bits par canal + un bit p impose, partage par les 4 canaux
+    static void quantizeBC7Endpoint(const float* e, int* q, int p) {
+        for (int c = 0; c < 4; c++) {
+            float v = std::min(255.0f, std::max(0.0f, e[c]));
+            q[c] = clampi(static_cast<int>((v - p) / 2.0f + 0.5f), 0, 127);
+        }
+    }
+
+    // indice le plus proche pour chaque pixel ; renvoie l'erreur quadratique du bloc
+    static int chooseBC7Indices(const uint8_t* block, const int* q0, int p0, const int* q1, int p1, uint8_t* indices) {
+        int palette[16][4];
+        for (int k = 0; k < 16; k++)
+            for (int c = 0; c < 4; c++) palette[k][c] = bc7Interpolate((q0[c] << 1) | p0, (q1[c] << 1) | p1, k);
+        int total = 0;
+        for (int i = 0; i < 16; i++) {
+            int best = 0, bestErr = 1 << 30;
+            for (int k = 0; k < 16; k++) {
+                int err = 0;
+                for (int c = 0; c < 4; c++) {
+                    int d = palette[k][c] - block[i * 4 + c];
+                    err += d * d;
+                }
+                if (err < bestErr) { bestErr = err; best = k; }
+            }
+            indices[i] = static_cast<uint8_t>(best);
+            total += bestErr;
+        }
+        return total;
+    }
+};
+
+#endif
@@ -0,0 +1,420 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include <glad.h>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include "Profiler.h"
+#include "TextureArray.h"
+#include "TextureCompress.h"
+#include "stb_image.h"
+
+// chargement de textures en arriere-plan :
+// - decodage des images sur les workers du systeme de jobs
+// - envoi au GPU sur le thread GL, par tranches de lignes via un anneau de PBO,
+//   dans la limite d'un budget d'octets par frame
+// si un .ktx (tools/texcompress) existe a cote de l'image, ses niveaux BC1/BC3/BC7
+// sont envoyes tels quels (glCompressedTexImage2D, ou glCompressedTexSubImage3D dans une
+// couche de tableau compresse) : ni decodage ni mips au demarrage
+// request() renvoie tout de suite une texture de remplacement ; le callback recoit
+// la vraie texture quand elle est complete (mipmaps compris)
+// requestLayer() remplit une couche d'un TextureArray : niveaux du KTX si le tableau est
+// compresse, sinon image decodee et mips calcules sur le worker
+class TextureStreamer {
+public:
+    typedef std::function<void(GLuint)> ReadyCallback;
+
+    struct Stats {
+        size_t bytesThisFrame = 0;
+        size_t pending = 0;      // en decodage ou en cours d'envoi
+        size_t completed = 0;
+    };
+
+    size_t frameBudget;            // octets envoyes au GPU par frame
+    static const int RingSize = 3; // PBO en vol (une frame d'avance pour le pilote)
+
+    explicit TextureStreamer(size_t frameBudgetBytes = 4 << 20, JobSystem& jobs = JobSystem::instance())
+        : frameBudget(frameBudgetBytes), jobs(jobs) {}
+
+    ~TextureStreamer() { release(); }
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // a appeler une fois le contexte GL cree
+    void init() {
+        stbi_set_flip_vertically_on_load(true);
+
+        // damier gris 2x2 en attendant les vraies textures
+        const unsigned char pixels[16] = { 160, 160, 160, 255,  96, 96, 96, 255,
+                                           96, 96, 96, 255,  160, 160, 160, 255 };
+        glGenTextures(1, &placeholder);
+        glBindTexture(GL_TEXTURE_2D, placeholder);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+        // formats compresses geres par le pilote
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (GLint i = 0; i < extensionCount; i++) {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (!name) continue;
+            if (std::strcmp(name, "GL_EXT_texture_compression_s3tc") == 0) supportsS3TC = true;
+            if (std::strcmp(name, "GL_ARB_texture_compression_bptc") == 0) supportsBPTC = true;
+        }
+
+        glGenBuffers(RingSize, pbos);
+        for (int i = 0; i < RingSize; i++) {
+            fences[i] = nullptr;
+            pboSizes[i] = 0;
+        }
+    }
+
+    GLuint placeholderTexture() const { return placeholder; }
+
+    // format des couches pour ces images : celui de leurs KTX si toutes en ont un, gere par
+    // le pilote, de meme format et de meme taille ; sinon RGBA8 1024x1024 (images decodees)
+    void layerFormat(const std::vector<std::string>& paths, int& width, int& height, GLenum& internalFormat) const {
+        width = height = 1024;
+        internalFormat = GL_RGBA8;
+        TextureCompress::KtxView first;
+        for (size_t i = 0; i < paths.size(); i++) {
+            MappedFile file;
+            TextureCompress::KtxView view;
+            if (!file.open(compressedPath(paths[i])) || !TextureCompress::readKTX(file, view) || !supports(view)) return;
+            if (i == 0) first = view;
+            else if (view.glInternalFormat != first.glInternalFormat || view.width != first.width || view.height != first.height) return;
+        }
+        if (paths.empty()) return;
+        width = first.width;
+        height = first.height;
+        internalFormat = first.glInternalFormat;
+    }
+
+    // lance le decodage ; renvoie la texture de remplacement
+    GLuint request(const std::string& path, ReadyCallback onReady) {
+        std::shared_ptr<Request> req(new Request());
+        req->path = path;
+        req->onReady = std::move(onReady);
+        stats.pending++;
+
+        jobs.runBackground([this, req] {
+            PROFILE_ZONE("decodage texture");
+            if (!loadCompressed(*req)) {
+                req->pixels = stbi_load(req->path.c_str(), &req->width, &req->height, &req->channels, 4);
+                if (!req->pixels) std::cerr << "Fail : " << req->path << std::endl;
+            }
+            std::lock_guard<std::mutex> lock(decodedMutex);
+            decoded.push_back(req);
+        }, &decodeJobs);
+        return placeholder;
+    }
+
+    // reserve une couche du tableau et lance le decodage ; renvoie la couche (-1 si plein)
+    // onReady recoit l'identifiant du tableau une fois tous les mips de la couche envoyes
+    int requestLayer(const std::string& path, TextureArray& array, ReadyCallback onReady = nullptr) {
+        int layer = array.addLayer();
+        if (layer < 0) return -1;
+        std::shared_ptr<Request> req(new Request());
+        req->path = path;
+        req->onReady = std::move(onReady);
+        req->array = &array;
+        req->layer = layer;
+        stats.pending++;
+
+        jobs.runBackground([this, req] {
+            PROFILE_ZONE("decodage couche");
+            if (req->array->compressed()) {
+                // niveaux copies tels quels depuis le fichier projete
+                if (!loadCompressed(*req) || !req->array->accepts(req->ktx)) {
+                    std::cerr << "KTX absent ou incompatible avec le tableau : " << compressedPath(req->path) << std::endl;
+                    req->file.reset();
+                }
+                std::lock_guard<std::mutex> lock(decodedMutex);
+                decoded.push_back(req);
+                return;
+            }
+            unsigned char* pixels = stbi_load(req->path.c_str(), &req->width, &req->height, &req->channels, 4);
+            if (pixels) {
+                TextureImage image(req->width, req->height);
+                std::memcpy(image.rgba.data(), pixels, image.rgba.size());
+                stbi_image_free(pixels);
+                req->mips = req->array->prepareLayer(image);
+            } else {
+                std::cerr << "Fail : " << req->path << std::endl;
+            }
+            std::lock_guard<std::mutex> lock(decodedMutex);
+            decoded.push_back(req);
+        }, &decodeJobs);
+        return layer;
+    }
+
+    // une fois par frame sur le thread GL
+    void update() {
+        stats.bytesThisFrame = 0;
+
+        // PBO dont le GPU a fini la copie
+        for (int i = 0; i < RingSize; i++) {
+            if (!fences[i]) continue;
+            GLenum state = glClientWaitSync(fences[i], 0, 0);
+            if (state == GL_ALREADY_SIGNALED || state == GL_CONDITION_SATISFIED) {
+                glDeleteSync(fences[i]);
+                fences[i] = nullptr;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(decodedMutex);
+            while (!decoded.empty()) {
+                uploads.push_back(decoded.front());
+                decoded.pop_front();
+            }
+        }
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        while (!uploads.empty() && stats.bytesThisFrame < frameBudget) {
+            std::shared_ptr<Request> req = uploads.front();
+            if (req->file) {
+                // niveaux deja compresses : copies directement depuis le fichier projete,
+                // un niveau a la fois (au moins un par frame)
+                const TextureCompress::CompressedLevelView& level = req->ktx.levels[req->nextLevel];
+                int levelCount = static_cast<int>(req->ktx.levels.size());
+                if (req->array) {
+                    req->array->bind();
+                    glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, req->nextLevel, 0, 0, req->layer, level.width, level.height, 1,
+                                              req->ktx.glInternalFormat, static_cast<GLsizei>(level.size), level.data);
+                    levelCount = req->array->levelCount();
+                } else {
+                    if (!req->texture) beginUpload(*req);
+                    glBindTexture(GL_TEXTURE_2D, req->texture);
+                    glCompressedTexImage2D(GL_TEXTURE_2D, req->nextLevel, req->ktx.glInternalFormat, level.width, level.height, 0,
+                                           static_cast<GLsizei>(level.size), level.data);
+                }
+                stats.bytesThisFrame += level.size;
+                if (++req->nextLevel >= levelCount) {
+                    finishUpload(*req);
+                    uploads.pop_front();
+                }
+                continue;
+            }
+            if (!req->pixels && req->mips.empty()) {
+                // echec du decodage : on garde le remplacement
+                uploads.pop_front();
+                stats.pending--;
+                continue;
+            }
+            if (!req->texture && !req->array) beginUpload(*req);
+
+            int slot = freePbo();
+            if (slot < 0) break; // tous les PBO sont encore lus par le GPU
+
+            // niveau en cours : image entiere (mips generes par le GPU) ou mip d'une couche
+            const unsigned char* source = req->pixels;
+            int levelWidth = req->width, levelHeight = req->height;
+            if (req->array) {
+                const TextureImage& mip = req->mips[req->nextLevel];
+                source = mip.rgba.data();
+                levelWidth = mip.width;
+                levelHeight = mip.height;
+            }
+
+            // tranche de lignes qui tient dans le budget restant (au moins une ligne)
+            const size_t rowBytes = static_cast<size_t>(levelWidth) * 4;
+            size_t budgetLeft = frameBudget - stats.bytesThisFrame;
+            int rows = static_cast<int>(std::max<size_t>(1, budgetLeft / rowBytes));
+            rows = std::min(rows, levelHeight - req->nextRow);
+            size_t bytes = rows * rowBytes;
+
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[slot]);
+            if (pboSizes[slot] < bytes) {
+                glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+                pboSizes[slot] = bytes;
+            }
+            void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+            if (dst) {
+                std::memcpy(dst, source + req->nextRow * rowBytes, bytes);
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                if (req->array) {
+                    req->array->bind();
+                    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, req->nextLevel, 0, req->nextRow, req->layer, levelWidth, rows, 1,
+                                    GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+                } else {
+                    glBindTexture(GL_TEXTURE_2D, req->texture);
+                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, req->nextRow, req->width, rows, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+                }
+                fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            }
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+            req->nextRow += rows;
+            stats.bytesThisFrame += bytes;
+
+            if (req->nextRow >= levelHeight) {
+                if (req->array && ++req->nextLevel < static_cast<int>(req->mips.size())) {
+                    req->nextRow = 0; // mip suivant de la couche
+                    continue;
+                }
+                finishUpload(*req);
+                uploads.pop_front();
+            }
+        }
+    }
+
+    const Stats& statistics() const { return stats; }
+
+    // attend les decodages en cours et libere les objets GL (contexte encore actif)
+    void release() {
+        if (!placeholder) return;
+        jobs.wait(decodeJobs);
+        for (auto& req : decoded) stbi_image_free(req->pixels);
+        for (auto& req : uploads) {
+            stbi_image_free(req->pixels);
+            if (req->texture) glDeleteTextures(1, &req->texture);
+        }
+        decoded.clear();
+        uploads.clear();
+        for (int i = 0; i < RingSize; i++)
+            if (fences[i]) glDeleteSync(fences[i]);
+        glDeleteBuffers(RingSize, pbos);
+        glDeleteTextures(1, &placeholder);
+        placeholder = 0;
+    }
+
+private:
+    struct Request {
+        std::string path;
+        ReadyCallback onReady;
+        unsigned char* pixels = nullptr;   // RGBA8
+        int width = 0, height = 0, channels = 0;
+        GLuint texture = 0;
+        int nextRow = 0;                   // premiere ligne pas encore envoyee
+
+        std::unique_ptr<MappedFile> file;  // KTX projete (null si image classique)
+        TextureCompress::KtxView ktx;
+        int nextLevel = 0;
+
+        TextureArray* array = nullptr;     // couche de tableau (null pour une texture 2D)
+        int layer = -1;
+        std::vector<TextureImage> mips;    // mips de la couche, prepares sur le worker
+    };
+
+    JobSystem& jobs;
+    JobCounter decodeJobs;
+
+    std::mutex decodedMutex;
+    std::deque<std::shared_ptr<Request>> decoded;   // rempli par les workers
+    std::deque<std::shared_ptr<Request>> uploads;   // thread GL uniquement
+
+    GLuint placeholder = 0;
+    bool supportsS3TC = false;   // BC1 / BC3
+    bool supportsBPTC = false;   // BC7
+    GLuint pbos[RingSize] = { 0, 0, 0 };
+    GLsync fences[RingSize] = { nullptr, nullptr, nullptr };
+    size_t pboSizes[RingSize] = { 0, 0, 0 };
+    int nextPbo = 0;
+
+    Stats stats;
+
+    int freePbo() {
+        for (int i = 0; i < RingSize; i++) {
+            int slot = (nextPbo + i) % RingSize;
+            if (!fences[slot]) {
+                nextPbo = (slot + 1) % RingSize;
+                return slot;
+            }
+        }
+        return -1;
+    }
+
+    // chemin.ktx a cote de l'image (ou le chemin lui-meme s'il est deja en .ktx)
+    static std::string compressedPath(const std::string& path) {
+        size_t dot = path.find_last_of('.');
+        size_t slash = path.find_last_of("/\\");
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return path + ".ktx";
+        return path.substr(0, dot) + ".ktx";
+    }
+
+    // thread worker : vrai si un KTX lisible dans un format gere a ete trouve
+    bool loadCompressed(Request& req) {
+        std::unique_ptr<MappedFile> file(new MappedFile());
+        if (!file->open(compressedPath(req.path))) return false;
+        TextureCompress::KtxView view;
+        if (!TextureCompress::readKTX(*file, view)) {
+            std::cerr << "KTX invalide : " << compressedPath(req.path) << std::endl;
+            return false;
+        }
+        if (!supports(view)) return false; // on retombe sur l'image source
+        req.width = view.width;
+        req.height = view.height;
+        req.channels = 4;
+        req.ktx = std::move(view);
+        req.file = std::move(file);
+        return true;
+    }
+
+    bool supports(const TextureCompress::KtxView& view) const {
+        return view.format == BlockFormat::BC7 ? supportsBPTC : supportsS3TC;
+    }
+
+    void beginUpload(Request& req) {
+        glGenTextures(1, &req.texture);
+        glBindTexture(GL_TEXTURE_2D, req.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        if (req.file) {
+            // chaine de mips fournie par le fichier (pas forcement jusqu'a 1x1)
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(req.ktx.levels.size()) - 1);
+            return;
+        }
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, req.width, req.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+
+    void finishUpload(Request& req) {
+        if (req.array) {
+            std::cout << "Texture : " << (req.file ? compressedPath(req.path) : req.path)
+                      << " | Width: " << req.width
+                      << ", Height: " << req.height
+                      << " -> couche " << req.layer << " (" << req.array->levelCount() << " mips"
+                      << (req.file ? ", compressee)" : ")") << std::endl;
+            req.mips.clear();
+            req.file.reset();
+            stats.pending--;
+            stats.completed++;
+            if (req.onReady) req.onReady(req.array->id());
+            return;
+        }
+        glBindTexture(GL_TEXTURE_2D, req.texture);
+        if (req.file) {
+            std::cout << "Texture : " << compressedPath(req.path)
+                      << " | Width: " << req.width
+                      << ", Height: " << req.height
+                      << ", Mips: " << req.ktx.levels.size() << " (compressee)" << std::endl;
+            req.file.reset();
+        } else {
+            glGenerateMipmap(GL_TEXTURE_2D);
+            std::cout << "Texture : " << req.path
+                      << " | Width: " << req.width
+                      << ", Height: " << req.height
+                      << ", Channels: " << req.channels << std::endl;
+        }
+        stbi_image_free(req.pixels);
+        req.pixels = nullptr;
+        stats.pending--;
+        stats.completed++;
+        if (req.onReady) req.onReady(req.texture);
+    }
+};
+
+#endif
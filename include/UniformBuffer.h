@@ -0,0 +1,60 @@
+#ifndef UNIFORM_BUFFER_H
+#define UNIFORM_BUFFER_H
+
+#include <glad.h>
+#include <glm/glm.hpp>
+
+// points de liaison des blocs d'uniformes partages par tous les shaders
+enum UniformBinding : GLuint {
+    FrameDataBinding = 0
+};
+
+// miroir std140 du bloc FrameData des shaders (vec3 passes en vec4 : alignement de 16 octets)
+struct FrameData {
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::vec4 lightPos;     // xyz
+    glm::vec4 lightColor;   // xyz
+    glm::vec4 viewPos;      // xyz : position de la camera
+};
+static_assert(sizeof(FrameData) == 2 * 64 + 3 * 16, "FrameData doit suivre la disposition std140");
+
+// buffer d'uniformes de type T relie a un point de liaison fixe :
+// un seul envoi par frame au lieu d'un glUniform par variable et par shader
+template <typename T>
+class UniformBuffer {
+public:
+    explicit UniformBuffer(GLuint binding) : binding(binding) {}
+    ~UniformBuffer() { release(); }
+
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    // a appeler une fois le contexte GL cree
+    void init() {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(T), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    void update(const T& data) {
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(T), &data);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    GLuint bindingPoint() const { return binding; }
+
+    void release() {
+        if (buffer) glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+
+private:
+    GLuint binding;
+    GLuint buffer = 0;
+};
+
+#endif
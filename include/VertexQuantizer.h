@@ -0,0 +1,137 @@
+#ifndef VERTEX_QUANTIZER_H
+#define VERTEX_QUANTIZER_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Mesh.h"
+
+// erreurs maximales introduites par la compression (mesurees sur CPU)
+struct QuantizationError {
+    float position = 0.0f;      // distance max en unites du modele
+    float normalDegrees = 0.0f; // ecart angulaire max des normales
+    float texcoord = 0.0f;      // ecart max en uv
+};
+
+// compression des sommets : positions et uv sur 16 bits relatifs aux bornes, normales octaedriques 2x16 bits
+class VertexQuantizer {
+public:
+    // seuils pour accepter le format compresse (relatifs a la taille du maillage / d'un texel 4096)
+    float maxPositionError = 1e-4f;
+    float maxNormalDegrees = 0.1f;
+    float maxTexcoordError = 1.0f / 4096.0f;
+
+    static VertexDecode computeDecode(const MeshView& mesh) {
+        VertexDecode decode;
+        decode.octNormals = true;
+        if (mesh.vertexCount == 0) return decode;
+
+        glm::vec3 extent = glm::max(mesh.maxBounds - mesh.minBounds, glm::vec3(1e-20f));
+        decode.position = glm::translate(glm::mat4(1.0f), mesh.minBounds);
+        decode.position = glm::scale(decode.position, extent);
+
+        glm::vec2 uvMin = mesh.vertices[0].TexCoords, uvMax = uvMin;
+        for (size_t i = 0; i < mesh.vertexCount; i++) {
+            uvMin = glm::min(uvMin, mesh.vertices[i].TexCoords);
+            uvMax = glm::max(uvMax, mesh.vertices[i].TexCoords);
+        }
+        glm::vec2 uvExtent = glm::max(uvMax - uvMin, glm::vec2(1e-20f));
+        decode.texcoord = glm::vec4(uvExtent.x, uvExtent.y, uvMin.x, uvMin.y);
+        return decode;
+    }
+
+    static void pack(const MeshView& mesh, const VertexDecode& decode, std::vector<PackedVertex>& out) {
+        glm::vec3 minBounds(decode.position[3]);
+        glm::vec3 extent(decode.position[0][0], decode.position[1][1], decode.position[2][2]);
+        glm::vec2 uvScale(decode.texcoord.x, decode.texcoord.y);
+        glm::vec2 uvOffset(decode.texcoord.z, decode.texcoord.w);
+
+        out.resize(mesh.vertexCount);
+        for (size_t i = 0; i < mesh.vertexCount; i++) {
+            const Vertex& v = mesh.vertices[i];
+            PackedVertex& p = out[i];
+            glm::vec3 pos = (v.Position - minBounds) / extent;
+            for (int k = 0; k < 3; k++) p.Position[k] = quantizeUnorm(pos[k]);
+            p.Position[3] = 0;
+
+            glm::vec2 oct = octEncode(v.Normal);
+            p.Normal[0] = quantizeSnorm(oct.x);
+            p.Normal[1] = quantizeSnorm(oct.y);
+
+            glm::vec2 uv = (v.TexCoords - uvOffset) / uvScale;
+            p.TexCoords[0] = quantizeUnorm(uv.x);
+            p.TexCoords[1] = quantizeUnorm(uv.y);
+        }
+    }
+
+    // decode sur CPU comme le fait le shader pour mesurer l'erreur reelle
+    static QuantizationError measureError(const MeshView& mesh, const std::vector<PackedVertex>& packed,
+                                          const VertexDecode& decode) {
+        QuantizationError error;
+        float maxNormalCos = 1.0f;
+        for (size_t i = 0; i < mesh.vertexCount; i++) {
+            const Vertex& v = mesh.vertices[i];
+            const PackedVertex& p = packed[i];
+
+            glm::vec4 pos = decode.position * glm::vec4(p.Position[0] / 65535.0f, p.Position[1] / 65535.0f,
+                                                         p.Position[2] / 65535.0f, 1.0f);
+            error.position = std::max(error.position, glm::length(glm::vec3(pos) - v.Position));
+
+            if (glm::length(v.Normal) > 0.0f) {
+                glm::vec3 n = octDecode(glm::vec2(std::max(p.Normal[0] / 32767.0f, -1.0f),
+                                                  std::max(p.Normal[1] / 32767.0f, -1.0f)));
+                maxNormalCos = std::min(maxNormalCos, glm::dot(n, glm::normalize(v.Normal)));
+            }
+
+            glm::vec2 uv(p.TexCoords[0] / 65535.0f * decode.texcoord.x + decode.texcoord.z,
+                         p.TexCoords[1] / 65535.0f * decode.texcoord.y + decode.texcoord.w);
+            error.texcoord = std::max(error.texcoord, std::max(std::fabs(uv.x - v.TexCoords.x), std::fabs(uv.y - v.TexCoords.y)));
+        }
+        error.normalDegrees = glm::degrees(std::acos(glm::clamp(maxNormalCos, -1.0f, 1.0f)));
+        return error;
+    }
+
+    // choisit le format : compresse si les erreurs restent sous les seuils
+    VertexLayout chooseLayout(const MeshView& mesh, const QuantizationError& error) const {
+        if (mesh.vertexCount == 0) return VertexLayout::Float;
+        float diagonal = glm::length(mesh.maxBounds - mesh.minBounds);
+        if (error.position > maxPositionError * diagonal) return VertexLayout::Float;
+        if (error.normalDegrees > maxNormalDegrees) return VertexLayout::Float;
+        if (error.texcoord > maxTexcoordError) return VertexLayout::Float;
+        return VertexLayout::Packed;
+    }
+
+    // encodage octaedrique : projection sur l'octaedre puis depliage des faces du bas
+    static glm::vec2 octEncode(const glm::vec3& normal) {
+        float l1 = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+        if (l1 <= 0.0f) return glm::vec2(0.0f);
+        glm::vec2 p(normal.x / l1, normal.y / l1);
+        if (normal.z < 0.0f) {
+            glm::vec2 folded((1.0f - std::fabs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f),
+                             (1.0f - std::fabs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f));
+            p = folded;
+        }
+        return p;
+    }
+
+    static glm::vec3 octDecode(const glm::vec2& e) {
+        glm::vec3 n(e.x, e.y, 1.0f - std::fabs(e.x) - std::fabs(e.y));
+        float t = std::max(-n.z, 0.0f);
+        n.x += n.x >= 0.0f ? -t : t;
+        n.y += n.y >= 0.0f ? -t : t;
+        return glm::normalize(n);
+    }
+
+private:
+    static uint16_t quantizeUnorm(float v) {
+        return static_cast<uint16_t>(std::lround(glm::clamp(v, 0.0f, 1.0f) * 65535.0f));
+    }
+
+    static int16_t quantizeSnorm(float v) {
+        return static_cast<int16_t>(std::lround(glm::clamp(v, -1.0f, 1.0f) * 32767.0f));
+    }
+};
+
+#endif
@@ -37,9 +37,10 @@ void main()
 
 out vec4 FragColor;
 in vec2 TexCoord;
-uniform sampler2D ourTexture;
+flat in float Layer;
+uniform sampler2DArray ourTextures; // toutes les textures de materiau, une par couche
 
 void main()
 {
-    FragColor = texture(ourTexture, TexCoord);
+    FragColor = texture(ourTextures, vec3(TexCoord, Layer));
 }
\ No newline at end of file
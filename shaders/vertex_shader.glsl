@@ -4,19 +4,67 @@
 layout(location = 0) in vec3 aPos;       // position du sommet
 layout(location = 1) in vec3 aNormal;    // pormal du sommet
 layout(location = 2) in vec2 aTexCoord;  // coord de texture
+layout(location = 3) in mat4 aInstanceModel; // matrice modele par instance (locations 3 a 6)
+layout(location = 7) in vec4 aInstanceMaterial;  // x = couche du tableau de textures, y = normales octaedriques
+layout(location = 8) in vec4 aInstancePosScale;  // decodage des positions par instance (xyz = echelle)
+layout(location = 9) in vec4 aInstancePosOffset; // xyz = decalage
+layout(location = 10) in vec4 aInstanceTexDecode; // xy = echelle, zw = decalage
 
 out vec3 FragPos;        // position fragment dans l'espace monde
 out vec3 Normal;         // normal fragment
 out vec2 TexCoord;       // coord de texture fragment
+flat out float Layer;    // couche du tableau de textures
+
+// donnees de la frame, communes a tous les shaders (UniformBuffer<FrameData>, liaison 0)
+layout(std140) uniform FrameData {
+    mat4 projection;     // matrice projection
+    mat4 view;           // matrice vue
+    vec4 lightPos;       // position de la lumiere (xyz)
+    vec4 lightColor;     // couleur de la lumiere (xyz)
+    vec4 viewPos;        // position de la camera (xyz)
+};
 
 uniform mat4 model;      // matrice modele
-uniform mat4 view;       // matrice vue
-uniform mat4 projection; // matrice projection
+uniform bool instanced;  // vrai : matrice modele, couche et decodage lus dans les attributs d'instance
+uniform float layer;     // couche de texture hors instanciation
+
+// decodage des sommets compresses hors instanciation (identite pour les sommets float)
+uniform mat4 decodePosition;  // position normalisee -> espace modele
+uniform vec4 decodeTexCoord;  // xy = echelle, zw = decalage
+uniform bool octNormals;      // normale en encodage octaedrique dans aNormal.xy
+
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0)); // calcule de la position dans l'espace monde
-    Normal = mat3(transpose(inverse(model))) * aNormal; // calcule\ de la normale dans l'espace monde
-    TexCoord = aTexCoord; // on passe les coord de texture
+    vec3 localPos;
+    vec3 localNormal;
+    vec4 texDecode;
+    mat4 world;
+    if (instanced) {
+        // maillages de bornes differentes dans un meme multi-draw : decodage par instance
+        localPos = aPos * aInstancePosScale.xyz + aInstancePosOffset.xyz;
+        localNormal = aInstanceMaterial.y > 0.5 ? octDecode(aNormal.xy) : aNormal;
+        texDecode = aInstanceTexDecode;
+        world = aInstanceModel;
+        Layer = aInstanceMaterial.x;
+    } else {
+        localPos = vec3(decodePosition * vec4(aPos, 1.0));
+        localNormal = octNormals ? octDecode(aNormal.xy) : aNormal;
+        texDecode = decodeTexCoord;
+        world = model;
+        Layer = layer;
+    }
+
+    FragPos = vec3(world * vec4(localPos, 1.0)); // calcule de la position dans l'espace monde
+    Normal = mat3(transpose(inverse(world))) * localNormal; // calcule\ de la normale dans l'espace monde
+    TexCoord = aTexCoord * texDecode.xy + texDecode.zw; // on passe les coord de texture
     gl_Position = projection * view * vec4(FragPos, 1.0); // transformation vers l'espace de projection
 }
@@ -0,0 +1,226 @@
+// Eyub Celebioglu
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include "Engine.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjParser.h"
+#include "Profiler.h"
+#include "RayQuery.h"
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+// MAJ la physique de tous les corps (le sol est un plan a la hauteur de ground)
+// puis collisions entre corps via la broadphase
+void updatePhysics(PhysicsWorld& world, Broadphase& broadphase, float deltaTime, const Ground& ground) {
+    PROFILE_ZONE("physique");
+    world.groundHeight = ground.position.y;
+    world.step(deltaTime);
+    {
+        PROFILE_ZONE("broadphase");
+        broadphase.collide(world);
+    }
+}
+
+// cle d'un coin de face : triplet (position, texcoord, normale) du .obj
+struct FaceCornerHash {
+    size_t operator()(const ObjIndex& c) const {
+        // melange simple des trois indices (constante du nombre d'or 2^64 / phi, puis premier de xxHash64)
+        uint64_t h = static_cast<uint32_t>(c.v);
+        h = h * 0x9E3779B97F4A7C15ull ^ static_cast<uint32_t>(c.t);
+        h = h * 0xC2B2AE3D27D4EB4Full ^ static_cast<uint32_t>(c.n);
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+struct FaceCornerEqual {
+    bool operator()(const ObjIndex& a, const ObjIndex& b) const { return a.v == b.v && a.t == b.t && a.n == b.n; }
+};
+
+// fnc pour charger un fichier .obj
+bool loadOBJ(const std::string& path, MeshData& out) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    ObjData obj;
+    ObjParser parser;
+    if (!parser.parse(path, obj)) return false;
+
+    auto parseTime = std::chrono::high_resolution_clock::now();
+
+    std::vector<Vertex>& vertices = out.vertices;
+    std::vector<unsigned int>& indices = out.indices;
+    vertices.clear();
+    indices.clear();
+    out.lods.clear();
+    indices.reserve(obj.corners.size());
+
+    // table de soudure : un meme triplet v/t/n donne un seul sommet
+    std::unordered_map<ObjIndex, unsigned int, FaceCornerHash, FaceCornerEqual> vertexCache;
+    vertexCache.reserve(obj.corners.size() / 2);
+    bool missingNormals = false;
+
+    for (const ObjIndex& corner : obj.corners) {
+        auto it = vertexCache.find(corner);
+        if (it != vertexCache.end()) {
+            // sommet deja vu : on reutilise son indice
+            indices.push_back(it->second);
+            continue;
+        }
+        Vertex vertex;
+        vertex.Position = obj.positions[corner.v];
+        vertex.TexCoords = corner.t >= 0 ? obj.texcoords[corner.t] : glm::vec2(0.0f);
+        vertex.Normal = corner.n >= 0 ? obj.normals[corner.n] : glm::vec3(0.0f);
+        missingNormals |= corner.n < 0;
+
+        unsigned int newIndex = static_cast<unsigned int>(vertices.size());
+        vertices.push_back(vertex);
+        vertexCache.emplace(corner, newIndex);
+        indices.push_back(newIndex);
+    }
+
+    // faces sans 'vn' : normales lissees ponderees par l'aire des triangles
+    if (missingNormals) {
+        std::vector<glm::vec3> accum(vertices.size(), glm::vec3(0.0f));
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            const glm::vec3& a = vertices[indices[i]].Position;
+            const glm::vec3& b = vertices[indices[i + 1]].Position;
+            const glm::vec3& c = vertices[indices[i + 2]].Position;
+            glm::vec3 faceNormal = glm::cross(b - a, c - a);
+            for (int k = 0; k < 3; k++) accum[indices[i + k]] += faceNormal;
+        }
+        for (size_t i = 0; i < vertices.size(); i++) {
+            if (vertices[i].Normal == glm::vec3(0.0f) && glm::length(accum[i]) > 0.0f)
+                vertices[i].Normal = glm::normalize(accum[i]);
+        }
+    }
+
+    // indices 16 bits si tous les sommets sont adressables (moitie moins de memoire pour l'EBO)
+    if (vertices.size() <= 0xFFFF) {
+        out.indices16.assign(indices.begin(), indices.end());
+        out.indexType = GL_UNSIGNED_SHORT;
+    } else {
+        out.indices16.clear();
+        out.indexType = GL_UNSIGNED_INT;
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double parseSeconds = std::chrono::duration<double>(parseTime - startTime).count();
+    double totalSeconds = std::chrono::duration<double>(endTime - startTime).count();
+    double megabytes = obj.bytes / (1024.0 * 1024.0);
+
+    std::cout << "Chargement du modèle terminé !" << std::endl;
+    std::cout << "Nombre de sommets : " << vertices.size() << " (" << obj.corners.size() << " avant soudure, reduction x"
+              << (vertices.empty() ? 0.0f : static_cast<float>(obj.corners.size()) / vertices.size()) << ")" << std::endl;
+    std::cout << "Nombre de faces : " << obj.faceCount << " (" << indices.size() / 3 << " triangles)" << std::endl;
+    std::cout << "Indices : " << (out.indexType == GL_UNSIGNED_SHORT ? "16" : "32") << " bits" << std::endl;
+    std::cout << "Lecture : " << megabytes << " Mo en " << totalSeconds * 1000.0 << " ms ("
+              << (parseSeconds > 0.0 ? megabytes / parseSeconds : 0.0) << " Mo/s, "
+              << obj.chunkCount << (obj.chunkCount > 1 ? " blocs en parallele)" : " bloc)") << std::endl;
+
+    return true;
+}
+
+// passe d'optimisation optionnelle entre le chargement et l'envoi au GPU
+bool optimizeMeshes = true;
+
+// proportion de triangles gardee par chaque LOD (seuils d'utilisation dans ModelRegistry::lodScreenSizes)
+const float lodRatios[] = { 0.5f, 0.25f, 0.1f };
+
+// construit la chaine de LODs a la suite du LOD 0 dans le meme tableau d'indices
+void buildLods(MeshData& mesh) {
+    std::vector<Vertex>& vertices = mesh.vertices;
+    std::vector<unsigned int>& indices = mesh.indices;
+    std::vector<MeshLod>& lods = mesh.lods;
+    const size_t fullIndexCount = indices.size();
+    lods.clear();
+    lods.push_back({ 0, static_cast<uint32_t>(fullIndexCount), 0.0f });
+
+    std::vector<unsigned int> source(indices);
+    for (float ratio : lodRatios) {
+        size_t target = static_cast<size_t>(fullIndexCount / 3 * ratio) * 3;
+        float error = 0.0f;
+        std::vector<unsigned int> lod = MeshSimplifier::simplify(vertices.data(), vertices.size(), source, target, &error);
+        if (lod.empty() || lod.size() >= source.size()) break; // plus rien a simplifier
+        if (optimizeMeshes) MeshOptimizer::optimizeVertexCache(lod, vertices.size());
+
+        lods.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lod.size()), error });
+        indices.insert(indices.end(), lod.begin(), lod.end());
+        std::cout << "LOD " << lods.size() - 1 << " : " << lod.size() / 3 << " triangles (erreur " << error << ")" << std::endl;
+        source.swap(lod);
+    }
+}
+
+void optimizeLoadedMesh(MeshData& mesh) {
+    std::vector<Vertex>& vertices = mesh.vertices;
+    std::vector<unsigned int>& indices = mesh.indices;
+    VertexCacheStats before = MeshOptimizer::analyzeVertexCache(indices, vertices.size());
+
+    MeshOptimizer::optimizeVertexCache(indices, vertices.size());
+    MeshOptimizer::optimizeOverdraw(indices, vertices);
+
+    VertexCacheStats after = MeshOptimizer::analyzeVertexCache(indices, vertices.size());
+    std::cout << "Optimisation du maillage : ACMR " << before.acmr << " -> " << after.acmr
+              << ", ATVR " << before.atvr << " -> " << after.atvr << std::endl;
+}
+
+// prepare le maillage charge : optimisation du LOD 0, chaine de LODs puis ordre des sommets
+void processLoadedMesh(MeshData& mesh) {
+    if (optimizeMeshes) optimizeLoadedMesh(mesh);
+    buildLods(mesh);
+    if (optimizeMeshes) MeshOptimizer::optimizeVertexFetch(mesh.vertices, mesh.indices);
+
+    // les indices 16 bits doivent suivre le nouvel ordre et les LODs
+    if (mesh.indexType == GL_UNSIGNED_SHORT)
+        mesh.indices16.assign(mesh.indices.begin(), mesh.indices.end());
+}
+
+// charge un modele : cache binaire projete en memoire s'il est a jour, sinon .obj puis ecriture du cache
+bool loadModel(const std::string& path, MeshAsset& asset) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    const uint64_t options = optimizeMeshes ? MeshCache::Optimized : 0;
+    if (MeshCache::load(path, options, asset.mapping, asset.view)) {
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        std::cout << "Modèle chargé depuis le cache " << MeshCache::cachePath(path) << " en " << ms << " ms ("
+                  << asset.view.vertexCount << " sommets, " << asset.view.lods[0].indexCount / 3 << " triangles)" << std::endl;
+        return true;
+    }
+
+    if (!loadOBJ(path, asset.data)) return false;
+    processLoadedMesh(asset.data);
+    asset.view = asset.data.view();
+    if (MeshCache::write(path, options, asset.view))
+        std::cout << "Cache écrit : " << MeshCache::cachePath(path) << std::endl;
+    return true;
+}
+
+bool rayIntersectsAABB(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, const glm::vec3& boxMin, const glm::vec3& boxMax) {
+    // inverse sans division par zero : un rayon parallele a un axe reste valide
+    float tEnter;
+    return raySlab(rayOrigin, safeInverse(rayDirection), boxMin, boxMax, std::numeric_limits<float>::infinity(), tEnter);
+}
+
+// fnc pour calculer le rayon depuis la souris
+glm::vec3 screenToWorld(int mouseX, int mouseY, const glm::mat4& projection, const glm::mat4& view) {
+    glm::vec4 clipCoords(
+        (2.0f * mouseX) / 800.0f - 1.0f,
+        1.0f - (2.0f * mouseY) / 600.0f,
+        -1.0f,
+        1.0f
+    );
+
+    glm::mat4 invertedProjection = glm::inverse(projection);
+    glm::mat4 invertedView = glm::inverse(view);
+    glm::vec4 eyeCoords = invertedProjection * clipCoords;
+    eyeCoords.z = -1.0f;  // on pointe dans la direction negatives
+    eyeCoords.w = 0.0f;
+
+    glm::vec4 worldCoords = invertedView * eyeCoords;
+    glm::vec3 direction = glm::normalize(glm::vec3(worldCoords));
+
+    return direction; // rayon dans l'espace 3D
+}
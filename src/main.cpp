@@ -5,284 +5,31 @@
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <cstdint>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
 #include "Shader.h"
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include "Camera.h"
-
-// struct d'un sommet
-struct Vertex {
-    glm::vec3 Position;
-    glm::vec3 Normal;
-    glm::vec2 TexCoords;
-};
-
-// struct pour le sol (plan)
-struct Ground {
-    GLuint VAO, VBO;
-    glm::vec3 position;
-    glm::vec3 scale;
-    
-    Ground() : position(0.0f, -2.0f, 0.0f), scale(20.0f, 1.0f, 20.0f) {
-        float vertices[] = {
-            // positions          // normales         // coord de texture
-            -0.5f, 0.0f, -0.5f,  0.0f, 1.0f, 0.0f,  0.0f,  0.0f,
-             0.5f, 0.0f, -0.5f,  0.0f, 1.0f, 0.0f,  20.0f, 0.0f,
-             0.5f, 0.0f,  0.5f,  0.0f, 1.0f, 0.0f,  20.0f, 20.0f,
-            -0.5f, 0.0f,  0.5f,  0.0f, 1.0f, 0.0f,  0.0f,  20.0f
-        };
-        
-        unsigned int indices[] = {
-            0, 1, 2,
-            0, 2, 3
-        };
-        
-        GLuint EBO;
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glGenBuffers(1, &EBO);
-        
-        glBindVertexArray(VAO);
-        
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-        
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-        
-        // position
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-        
-        // normal
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-        
-        // texture
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-        
-        glBindVertexArray(0);
-    }
-    
-    void Draw(Shader& shader, GLuint texture) {
-        shader.use();
-        
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, position);
-        model = glm::scale(model, scale);
-        
-        shader.setMat4("model", model);
-        
-        glBindVertexArray(VAO);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-    }
-};
-
-struct PhysicsProperties {
-    glm::vec3 position;      // position de l'objet
-    glm::vec3 velocity;      // vitesse de l'objet
-    glm::vec3 acceleration;  // acc de l'objet
-    float mass;              // masse de l'objet
-    float restitution;       // coef de restitution (rebond) entre 0 et 1
-    bool isStatic;           // si l'objet est statique (comme le sol) ou dynamique
-    
-    PhysicsProperties() : 
-        position(0.0f),
-        velocity(0.0f),
-        acceleration(0.0f, -2.5f, 0.0f), // gravite reduite (au lieu de -9.81) / vous pouvez le changer 
-        mass(1.0f),
-        restitution(0.8f),   // rebond
-        isStatic(false)
-    {}
-};
-
-// struct pour representer un objet physique
-struct PhysicsObject {
-    glm::vec3 position;      // position actuelle
-    glm::vec3 scale;         // echelle de l'objet
-    glm::vec3 minBounds;     // lim min de la boite englobante
-    glm::vec3 maxBounds;     // lim max de la boite englobante
-    PhysicsProperties physics;
-    
-    PhysicsObject(const glm::vec3& pos, const glm::vec3& scl) :
-        position(pos),
-        scale(scl)
-    {
-        // calcul de la boite englobante en fonction de l'echelle
-        minBounds = position - scale * 0.5f;
-        maxBounds = position + scale * 0.5f;
-        
-        // Init des proprietes physiques
-        physics.position = position;
-    }
-    
-    // MAJ des lim de la boite englobante
-    void updateBounds() {
-        position = physics.position; // MAJ la position de rendu
-        minBounds = position - scale * 0.5f;
-        maxBounds = position + scale * 0.5f;
-    }
-};
-
-// Detecte la collision entre un objet et le sol
-bool checkCollisionWithGround(PhysicsObject& object, const Ground& ground) {
-    // verifie si l'objet est sous ou au niveau du sol
-    if (object.minBounds.y <= ground.position.y) {
-        return true;
-    }
-    return false;
-}
-
-// rep à la collision avec le sol
-void resolveGroundCollision(PhysicsObject& object, const Ground& ground) {
-    // calcul la profondeur de pene
-    float penetration = ground.position.y - object.minBounds.y;
-    
-    // repositionne l'objet au-dessus du sol
-    object.physics.position.y += penetration;
-    
-    // applique le rebond: inverser la vitesse Y et applique le coef de restitution
-    object.physics.velocity.y = -object.physics.velocity.y * object.physics.restitution;
-    
-    // Si vitesse est trres faible ap rebonda alors on arrete le mouvement pour eviter des rebonds infinis
-    if (std::abs(object.physics.velocity.y) < 0.1f) {
-        object.physics.velocity.y = 0.0f;
-    }
-    
-    // MAJ les lim
-    object.updateBounds();
-}
-
-// MAJ la physique pour un objet
-void updatePhysics(PhysicsObject& object, float deltaTime, const Ground& ground) {
-    if (object.physics.isStatic) return; // objets statiques ne bougent pas
-    
-    // facteur de ralentissement (0.5 = deux fois plus lent)
-    float slowFactor = 0.5f;
-    deltaTime *= slowFactor;
-    
-    // MAJ la vitesse selon l'accel
-    object.physics.velocity += object.physics.acceleration * deltaTime;
-    
-    // lim la vitesse maximale de chute
-    const float maxFallSpeed = 5.0f;
-    if (object.physics.velocity.y < -maxFallSpeed) {
-        object.physics.velocity.y = -maxFallSpeed;
-    }
-    
-    // MAJ la position selon la vitesse
-    object.physics.position += object.physics.velocity * deltaTime;
-    
-    // MAJ les lim de la boite englobante
-    object.updateBounds();
-    
-    // verifie et resoudre les collisions avec le sol
-    if (checkCollisionWithGround(object, ground)) {
-        resolveGroundCollision(object, ground);
-    }
-}
-
-// vecteur pour stocker les données du modele
-std::vector<Vertex> vertices;
-std::vector<unsigned int> indices;
-
-// fnc pour charger un fichier .obj
-bool loadOBJ(const std::string& path) {
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        std::cerr << "Erreur : Impossible d'ouvrir " << path << std::endl;
-        return false;
-    }
-
-    std::vector<glm::vec3> temp_positions;
-    std::vector<glm::vec3> temp_normals;
-    std::vector<glm::vec2> temp_texcoords;
-
-    std::string line;
-    int faceCount = 0; // compteur de face
-    while (std::getline(file, line)) {
-        std::istringstream s(line);
-        std::string type;
-        s >> type;
-
-        if (type == "v") {
-            glm::vec3 position;
-            s >> position.x >> position.y >> position.z;
-            temp_positions.push_back(position);
-        } else if (type == "vt") {
-            glm::vec2 texcoord;
-            s >> texcoord.x >> texcoord.y;
-            temp_texcoords.push_back(texcoord);
-        } else if (type == "vn") {
-            glm::vec3 normal;
-            s >> normal.x >> normal.y >> normal.z;
-            temp_normals.push_back(normal);
-        } else if (type == "f") {
-            unsigned int vIndex[3], tIndex[3], nIndex[3];
-            char slash;
-            for (int i = 0; i < 3; i++) {
-                s >> vIndex[i] >> slash >> tIndex[i] >> slash >> nIndex[i];
-                vIndex[i]--; tIndex[i]--; nIndex[i]--;
-            }
-            for (int i = 0; i < 3; i++) {
-                Vertex vertex;
-                vertex.Position = temp_positions[vIndex[i]];
-                vertex.TexCoords = temp_texcoords[tIndex[i]];
-                vertex.Normal = temp_normals[nIndex[i]];
-                vertices.push_back(vertex);
-                indices.push_back(indices.size());
-            }
-            faceCount++;
-        }
-    }
-
-    file.close();
-
-    std::cout << "Chargement du modèle terminé !" << std::endl;
-    std::cout << "Nombre de sommets : " << vertices.size() << std::endl;
-    std::cout << "Nombre de faces : " << faceCount << std::endl;
-
-    return true;
-}
-
-// OpenGL buffers
-GLuint modelVAO, modelVBO, modelEBO;
-
-// config du mesh chargee 
-void setupMesh() {
-    glGenVertexArrays(1, &modelVAO);
-    glGenBuffers(1, &modelVBO);
-    glGenBuffers(1, &modelEBO);
-
-    glBindVertexArray(modelVAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, modelVBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, modelEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Position));
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
-
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
-
-    glBindVertexArray(0);
-
-    // on affiche les u,v (doivent etre comprise entre 0 et 1 sinon pb)
-    std::cout << "UV Coordonnées : " << vertices[0].TexCoords.x << ", " << vertices[0].TexCoords.y << std::endl;
-
-}
+#include "Engine.h"
+#include "Mesh.h"
+#include "VertexQuantizer.h"
+#include "ModelRegistry.h"
+#include "Frustum.h"
+#include "PhysicsWorld.h"
+#include "Broadphase.h"
+#include "PhysicsThread.h"
+#include "JobSystem.h"
+#include "OcclusionCulling.h"
+#include "Profiler.h"
+#include "TextureArray.h"
+#include "TextureStreamer.h"
+#include "UniformBuffer.h"
+#include "Headless.h"
 
 // gestion des inputs
 Camera camera(glm::vec3(0.0f, 2.0f, 5.0f));
@@ -308,60 +55,12 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
     camera.ProcessMouseScroll(static_cast<float>(yoffset));
 }
 
-bool rayIntersectsAABB(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, const glm::vec3& boxMin, const glm::vec3& boxMax) {
-    float tMin = (boxMin.x - rayOrigin.x) / rayDirection.x;
-    float tMax = (boxMax.x - rayOrigin.x) / rayDirection.x;
-
-    if (tMin > tMax) std::swap(tMin, tMax);
-
-    float tyMin = (boxMin.y - rayOrigin.y) / rayDirection.y;
-    float tyMax = (boxMax.y - rayOrigin.y) / rayDirection.y;
-
-    if (tyMin > tyMax) std::swap(tyMin, tyMax);
-
-    if (tMin > tyMax || tyMin > tMax)
-        return false;
-
-    if (tyMin > tMin) tMin = tyMin;
-    if (tyMax < tMax) tMax = tyMax;
-
-    float tzMin = (boxMin.z - rayOrigin.z) / rayDirection.z;
-    float tzMax = (boxMax.z - rayOrigin.z) / rayDirection.z;
-
-    if (tzMin > tzMax) std::swap(tzMin, tzMax);
-
-    if (tMin > tzMax || tzMin > tMax)
-        return false;
-
-    return true;
-}
-
-// fnc pour calculer le rayon depuis la souris
-glm::vec3 screenToWorld(int mouseX, int mouseY, const glm::mat4& projection, const glm::mat4& view) {
-    glm::vec4 clipCoords(
-        (2.0f * mouseX) / 800.0f - 1.0f,
-        1.0f - (2.0f * mouseY) / 600.0f,
-        -1.0f,
-        1.0f
-    );
-
-    glm::mat4 invertedProjection = glm::inverse(projection);
-    glm::mat4 invertedView = glm::inverse(view);
-    glm::vec4 eyeCoords = invertedProjection * clipCoords;
-    eyeCoords.z = -1.0f;  // on pointe dans la direction negatives
-    eyeCoords.w = 0.0f;
-
-    glm::vec4 worldCoords = invertedView * eyeCoords;
-    glm::vec3 direction = glm::normalize(glm::vec3(worldCoords));
-
-    return direction; // rayon dans l'espace 3D
-}
-
 bool isMoveMode = true; // Si true : mode déplacement, si false : mode curseur
 float lastCursorX = 0.0f, lastCursorY = 0.0f;
 bool firstCursorSwitch = false;
+bool profileKeyDown = false;
 
-void processInput(GLFWwindow* window) {
+void processInput(GLFWwindow* window, const ModelRegistry& models) {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
 
@@ -430,17 +129,26 @@ void processInput(GLFWwindow* window) {
             glm::vec3 rayDirection = screenToWorld(static_cast<int>(mouseX), static_cast<int>(mouseY), 
                 glm::perspective(glm::radians(camera.Zoom), 800.0f / 600.0f, 0.1f, 100.0f), camera.GetViewMatrix());
 
-            glm::vec3 boxMin(-0.5f, -0.5f, -0.5f);
-            glm::vec3 boxMax(0.5f, 0.5f, 0.5f);
-
             glm::vec3 rayOrigin = camera.Position;
 
-            if (rayIntersectsAABB(rayOrigin, rayDirection, boxMin, boxMax)) {
-                std::cout << "Ray touche l obj" << std::endl;
+            // triangle exact via la BVH de chaque maillage
+            PickResult pick;
+            if (models.pick(rayOrigin, rayDirection, pick)) {
+                std::cout << "Ray touche l obj " << models.get(pick.model).name << " (instance " << pick.instance
+                          << ", triangle " << pick.triangle << ", distance " << pick.distance << ")" << std::endl;
             }
         }
     }
 
+    // P : ecrit la trace du profileur (chrome://tracing)
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS && !profileKeyDown) {
+        profileKeyDown = true;
+        Profiler& profiler = Profiler::instance();
+        profiler.exportChromeTrace("trace_" + std::to_string(profiler.lastFrame().index) + ".json");
+    }
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_RELEASE)
+        profileKeyDown = false;
+
     // reset de `firstCursorSwitch` quand la touche est lachee
     if (glfwGetKey(window, GLFW_KEY_U) == GLFW_RELEASE) {
         firstCursorSwitch = false;
@@ -448,133 +156,337 @@ void processInput(GLFWwindow* window) {
 }
 
 
-GLuint loadTexture(const char* path) {
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    int width, height, nrChannels;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(path, &width, &height, &nrChannels, 0);
-
-    if (data) {
-        GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
-        std::cout << "Texture : " << path 
-                  << " | Width: " << width 
-                  << ", Height: " << height 
-                  << ", Channels: " << nrChannels << std::endl;
-
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    } else {
-        std::cerr << "Fail : " << path << std::endl;
-    }
-    stbi_image_free(data);
+// options du mode sans fenetre (benchmark reproductible)
+struct HeadlessOptions {
+    bool enabled = false;
+    std::string cameraPath;
+    size_t frames = 600;
+    size_t warmup = 60;                 // frames ignorees (shaders, textures en cours de chargement)
+    std::string output = "benchmark.json";
+};
 
-    return textureID;
+// entier positif en base 10 ; faux si text contient autre chose que des chiffres
+bool parseCount(const char* text, size_t& value) {
+    if (*text < '0' || *text > '9') return false; // strtoul accepterait "-1" et les espaces
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE) return false;
+    value = static_cast<size_t>(parsed);
+    return true;
 }
 
-bool intersectRayWithObject(const glm::vec3& rayDirection) {
+// main --headless <chemin camera> [--frames N] [--warmup N] [--out fichier.json]
+bool parseArguments(int argc, char** argv, HeadlessOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--headless" && hasValue) {
+            options.enabled = true;
+            options.cameraPath = argv[++i];
+        } else if (arg == "--frames" && hasValue && parseCount(argv[i + 1], options.frames)) {
+            i++;
+        } else if (arg == "--warmup" && hasValue && parseCount(argv[i + 1], options.warmup)) {
+            i++;
+        } else if (arg == "--out" && hasValue) {
+            options.output = argv[++i];
+        } else {
+            std::cerr << "Usage : main [--headless <chemin camera> [--frames N] [--warmup N] [--out fichier.json]]" << std::endl;
+            return false;
+        }
+    }
     return true;
 }
 
+int main(int argc, char** argv) {
+    HeadlessOptions headless;
+    if (!parseArguments(argc, argv, headless)) return 1;
+
+    GLFWwindow* window = nullptr;
+    CameraPath cameraPath;
+#ifdef ENGINE_HEADLESS
+    HeadlessContext offscreen;
+#endif
+    if (headless.enabled) {
+        if (!cameraPath.load(headless.cameraPath)) return 1;
+#ifdef ENGINE_HEADLESS
+        if (!offscreen.init(800, 600)) return 1;
+#else
+        std::cerr << "Mode sans fenetre absent de ce binaire (make headless)" << std::endl;
+        return 1;
+#endif
+    } else {
+        if (!glfwInit()) return -1;
+        window = glfwCreateWindow(800, 600, "Eyub Engine", nullptr, nullptr);
 
-int main() {
-    if (!glfwInit()) return -1;
-    GLFWwindow* window = glfwCreateWindow(800, 600, "Eyub Engine", nullptr, nullptr);
+        if (!window) { 
+            glfwTerminate(); 
+            return -1; 
+        }
 
-    if (!window) { 
-        glfwTerminate(); 
-        return -1; 
+        glfwMakeContextCurrent(window);
+        glfwSetFramebufferSizeCallback(window, [](GLFWwindow*, int width, int height) { glViewport(0, 0, width, height); });
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) return -1;
     }
-
-    glfwMakeContextCurrent(window);
-    glfwSetFramebufferSizeCallback(window, [](GLFWwindow*, int width, int height) { glViewport(0, 0, width, height); });
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) return -1;
     
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetScrollCallback(window, scroll_callback);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    // zones CPU par thread et temps GPU, exportes avec P et a la fermeture
+    Profiler& profiler = Profiler::instance();
+    profiler.setThreadName("principal");
+    profiler.initGpu();
+
+    if (window) {
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetScrollCallback(window, scroll_callback);
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    }
     
     Shader shader("3Dengine/shaders/vertex_shader.glsl", "3Dengine/shaders/fragment_shader.glsl");
-
-    if (!loadOBJ("3Dengine/texture/exemple.obj")) return -1;
-    setupMesh();
+    shader.hotReload = !headless.enabled; // les .glsl modifies sont recompiles sans redemarrer
+    DrawUniforms drawUniforms(shader);
+
+    // matrices, lumiere et camera : un bloc std140 partage, envoye une fois par frame
+    UniformBuffer<FrameData> frameUniforms(FrameDataBinding);
+    frameUniforms.init();
+    shader.bindBlock("FrameData", FrameDataBinding);
+
+    // textures chargees en arriere-plan, chacune dans une couche du tableau de materiaux
+    // (grise jusqu'a ce qu'elle soit prete) : un seul bind pour toute la scene
+    // tableau BC si les deux images ont un KTX compatible (tools/texcompress), sinon RGBA8
+    const std::string modelTexture = "3Dengine/texture/texture_exemple.jpeg";
+    const std::string groundTexture = "3Dengine/texture/ground_exemple.jpg";
+    TextureStreamer textures;
+    textures.init();
+    int layerWidth, layerHeight;
+    GLenum layerFormat;
+    textures.layerFormat({ modelTexture, groundTexture }, layerWidth, layerHeight, layerFormat);
+    TextureArray materials(layerWidth, layerHeight, layerFormat);
+    materials.init(2); // modele et sol
+
+    ModelRegistry models;
+    std::unique_ptr<MeshAsset> asset(new MeshAsset());
+    if (!loadModel("3Dengine/texture/exemple.obj", *asset)) return -1;
     
-    GLuint texture = loadTexture("3Dengine/texture/texture_exemple.jpeg");
+    int modelLayer = textures.requestLayer(modelTexture, materials);
+    ModelHandle modelHandle = models.add("exemple", std::move(asset), std::max(modelLayer, 0));
     shader.use();
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texture); 
-    shader.setInt("ourTexture", 0);
+    shader.setInt("ourTextures", 0);
 
     // creation du sol 
     Ground ground;
-    GLuint groundTexture = loadTexture("3Dengine/texture/ground_exemple.jpg");
+    int groundLayer = std::max(textures.requestLayer(groundTexture, materials), 0);
+    ModelHandle groundHandle = models.add("sol", ground.makeAsset(), groundLayer);
 
     // var de lumiere
     glm::vec3 lightPos(1.0f, 1.0f, 1.0f);  // position de la lumiere
     glm::vec3 lightColor(1.0f, 1.0f, 1.0f); // couleur de la lumiere blanc
-    glm::vec3 viewPos = camera.Position; // position de la caméra
 
-    // Init de l'objet physique pour le modele 3D
-    PhysicsObject modelObject(glm::vec3(0.0f, 10.0f, 0.0f), // position de depart plus haute (10 au lieu de 5)
-                         glm::vec3(0.5f));             // echelle approximativee
-    modelObject.physics.restitution = 0.8f; // coef de rebond
+    // Init du corps physique pour le modele 3D
+    PhysicsWorld physicsWorld;
+    Broadphase broadphase;
+    BodyId modelBody = physicsWorld.addBody(glm::vec3(0.0f, 10.0f, 0.0f), // position de depart plus haute (10 au lieu de 5)
+                                            glm::vec3(0.5f),              // echelle approximativee
+                                            0.8f);                        // coef de rebond
+
+    // physique a 60 ticks/s sur son propre thread, independante de la frequence d'affichage
+    PhysicsThread physicsThread(physicsWorld, [&](float step) {
+        static bool named = false; // appele uniquement depuis le thread physique
+        if (!named) {
+            Profiler::instance().setThreadName("physique");
+            named = true;
+        }
+        updatePhysics(physicsWorld, broadphase, step, ground);
+    });
+    // sans fenetre : ticks executes par la boucle de rendu (voir physicsTicksPerFrame)
+    if (!headless.enabled) physicsThread.start();
 
     glEnable(GL_DEPTH_TEST);
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
-    while (!glfwWindowShouldClose(window)) {
-        float currentFrame = static_cast<float>(glfwGetTime());
+    // culling des boites englobantes contre le frustum de la camera
+    FrustumCuller culler;
+    float cullReportTime = 0.0f;
+
+    // culling d'occlusion sur CPU : le sol sert d'occultant (objets vus par dessous caches)
+    OcclusionCuller occlusion;
+
+    // tous les draws passent par la file : tri par etat puis profondeur
+    RenderQueue renderQueue;
+
+    // sans fenetre : pas de temps fixe, camera rejouee, GPU attendu a chaque frame
+    const float headlessStep = 1.0f / 60.0f;
+    const int physicsTicksPerFrame = std::max(1, static_cast<int>(std::lround(headlessStep / physicsThread.step())));
+    auto benchStart = std::chrono::steady_clock::now();
+    BenchmarkReport report;
+    size_t frameCount = 0;
+
+    while (window ? !glfwWindowShouldClose(window) : frameCount < headless.warmup + headless.frames) {
+        profiler.beginFrame();
+        auto frameStart = std::chrono::steady_clock::now();
+        float currentFrame = window ? static_cast<float>(glfwGetTime()) : frameCount * headlessStep;
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
         
-        processInput(window);
+        {
+            PROFILE_ZONE("entrees");
+            if (window) processInput(window, models);
+            else cameraPath.apply(camera, currentFrame);
+        }
+
+        // envoi au GPU des textures decodees (budget d'octets par frame)
+        {
+            PROFILE_ZONE("textures");
+            textures.update();
+        }
+
+        // shader recompile : nouveaux emplacements d'uniformes et liaisons
+        if (shader.pollReload()) {
+            drawUniforms = DrawUniforms(shader);
+            shader.bindBlock("FrameData", FrameDataBinding);
+            shader.use();
+            shader.setInt("ourTextures", 0);
+        }
         
-        // MAJ de la physique
-        updatePhysics(modelObject, deltaTime, ground);
+        // dernier etat publie par le thread physique, interpole entre ses deux derniers ticks
+        // sans fenetre : nombre fixe de ticks par frame et pas d'interpolation, deux rejeux donnent les memes images
+        if (!window) physicsThread.advance(physicsTicksPerFrame);
+        const PhysicsFrame& physicsFrame = physicsThread.acquire();
+        float physicsAlpha = window ? physicsThread.alpha(physicsFrame, PhysicsThread::now()) : 1.0f;
         
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         
         shader.use();
         
-        // var de la lumiere
-        shader.setVec3("lightPos", lightPos);
-        shader.setVec3("lightColor", lightColor);
-        shader.setVec3("viewPos", camera.Position);
-        
         glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), 800.0f / 600.0f, 0.1f, 100.0f);
         glm::mat4 view = camera.GetViewMatrix();
-        shader.setMat4("projection", projection);
-        shader.setMat4("view", view);
+
+        // donnees communes a tous les shaders de la frame
+        FrameData frameData;
+        frameData.projection = projection;
+        frameData.view = view;
+        frameData.lightPos = glm::vec4(lightPos, 1.0f);
+        frameData.lightColor = glm::vec4(lightColor, 1.0f);
+        frameData.viewPos = glm::vec4(camera.Position, 1.0f);
+        frameUniforms.update(frameData);
+
+        // boites du sol (plan d'epaisseur nulle) et du modele
+        int64_t zoneStart = profiler.now();
+        culler.clear();
+        glm::vec3 groundHalf(ground.scale.x * 0.5f, 0.0f, ground.scale.z * 0.5f);
+        size_t groundBox = culler.add(ground.position - groundHalf, ground.position + groundHalf);
+        glm::vec3 modelMin = physicsFrame.minBounds(modelBody, physicsAlpha), modelMax = physicsFrame.maxBounds(modelBody, physicsAlpha);
+        size_t modelBox = culler.add(modelMin, modelMax);
+        CullStats cullStats = culler.cull(camera.GetFrustum(projection));
+        profiler.record("culling", zoneStart, profiler.now());
+
+        // occultants rasterises avec la meme projection * vue que le rendu
+        {
+            PROFILE_ZONE("occlusion");
+            occlusion.clearOccluders();
+            occlusion.addOccluder(models.get(groundHandle).mesh(), ground.transform());
+            occlusion.render(projection * view);
+        }
+
+        // compteurs dans le titre de la fenetre (2 fois par seconde)
+        if (window && currentFrame - cullReportTime > 0.5f) {
+            cullReportTime = currentFrame;
+            std::string title = "Eyub Engine | visibles " + std::to_string(cullStats.visible)
+                              + " | caches " + std::to_string(cullStats.culled)
+                              + " | occultes " + std::to_string(occlusion.statistics().occluded)
+                              + " | tick physique " + std::to_string(physicsThread.lastTickMs()) + " ms"
+                              + " | draws " + std::to_string(renderQueue.statistics().draws)
+                              + " | appels " + std::to_string(renderQueue.statistics().batches)
+                              + " | etats evites " + std::to_string(renderQueue.statistics().avoidedChanges)
+                              + " | gpu " + std::to_string(profiler.lastGpuMs()) + " ms";
+            glfwSetWindowTitle(window, title.c_str());
+        }
         
+        zoneStart = profiler.now();
+        renderQueue.clear();
+        models.clearInstances();
+
         // dessiner le sol
-        ground.Draw(shader, groundTexture);
+        if (culler.visible(groundBox))
+            models.addInstance(groundHandle, ground.transform());
         
         // dessiner le modele principal avec sa position MAJ
         glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, modelObject.position); // utilise la position mise à jour
+        model = glm::translate(model, physicsFrame.position(modelBody, physicsAlpha)); // utilise la position mise à jour
         model = glm::scale(model, glm::vec3(0.01f));         // echelle d'origine
-        shader.setMat4("model", model);
-        
-        glBindVertexArray(modelVAO);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+
+        // toute la geometrie opaque d'un meme format de sommet part en un seul multi-draw
+        // le sol n'est pas teste : c'est l'occultant
+        if (culler.visible(modelBox)) {
+            bool occluded = !occlusion.visible(modelMin, modelMax);
+            occlusion.count(occluded);
+            if (!occluded) models.addInstance(modelHandle, model);
+        }
+        models.submitInstances(renderQueue, shader, drawUniforms, camera, materials.id());
+        profiler.record("soumission", zoneStart, profiler.now());
+
+        size_t frameDraws = 0;
+        {
+            PROFILE_ZONE("rendu");
+            profiler.beginGpu("scene");
+            const RenderQueueStats& renderStats = renderQueue.execute();
+            profiler.endGpu();
+            frameDraws = renderStats.draws;
+            profiler.count(ProfileDraws, renderStats.draws);
+            profiler.count(ProfileStateChanges, renderStats.stateChanges);
+            profiler.count(ProfileUploadBytes, renderStats.uploadBytes + textures.statistics().bytesThisFrame + sizeof(FrameData));
+        }
+        double cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
         
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        if (window) {
+            PROFILE_ZONE("swap");
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        } else {
+            // pas de swap pour limiter l'avance du CPU : on attend le GPU
+            PROFILE_ZONE("glFinish");
+            glFinish();
+        }
+        profiler.endFrame();
+
+        if (!window) {
+            if (frameCount == headless.warmup) benchStart = frameStart;
+            if (frameCount >= headless.warmup) {
+                double frameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+                report.add({ frameMs, cpuMs, -1.0, frameDraws });
+            }
+            // temps GPU lus avec quelques frames de retard
+            uint64_t gpuFrame = profiler.lastFrame().index >= Profiler::GpuLatency ? profiler.lastFrame().index - Profiler::GpuLatency : 0;
+            if (gpuFrame >= headless.warmup) report.setGpu(gpuFrame - headless.warmup, profiler.gpuMs(gpuFrame));
+        }
+        frameCount++;
+    }
+
+    if (!window) {
+        profiler.flushGpu();
+        uint64_t firstPending = frameCount > Profiler::GpuLatency ? frameCount - Profiler::GpuLatency : 0;
+        for (uint64_t f = std::max<uint64_t>(firstPending, headless.warmup); f < frameCount; f++)
+            report.setGpu(f - headless.warmup, profiler.gpuMs(f));
+#ifdef ENGINE_HEADLESS
+        std::string renderer = offscreen.renderer();
+#else
+        std::string renderer;
+#endif
+        double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - benchStart).count();
+        if (report.writeJSON(headless.output, headless.cameraPath, renderer, headless.warmup))
+            std::cout << "Benchmark : " << report.size() << " frames en " << wallSeconds << " s, resultats dans " << headless.output << std::endl;
     }
 
-    glDeleteVertexArrays(1, &modelVAO);
-    glDeleteBuffers(1, &modelVBO);
-    glDeleteBuffers(1, &modelEBO);
-    glfwTerminate();
+    physicsThread.stop();
+    profiler.exportChromeTrace("trace.json");
+    profiler.release();
+    textures.release();
+    materials.release();
+    frameUniforms.release();
+    models.release();
+#ifdef ENGINE_HEADLESS
+    offscreen.release();
+#endif
+    if (window) glfwTerminate();
     return 0;
 }
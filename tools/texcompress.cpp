@@ -0,0 +1,73 @@
+// compression de textures hors ligne :
+//   texcompress <entree.png|jpg> <sortie.ktx> [bc1|bc3|bc7] [box|kaiser]
+// genere la chaine de mips sur CPU, encode chaque niveau et ecrit un KTX 1.1
+// affiche le PSNR de chaque niveau (image decodee comparee a la source)
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "TextureCompress.h"
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage : texcompress <entree> <sortie.ktx> [bc1|bc3|bc7] [box|kaiser]" << std::endl;
+        return 1;
+    }
+    const std::string input = argv[1], output = argv[2];
+    const std::string formatName = argc > 3 ? argv[3] : "bc7";
+    const std::string filterName = argc > 4 ? argv[4] : "kaiser";
+
+    BlockFormat format;
+    if (formatName == "bc1") format = BlockFormat::BC1;
+    else if (formatName == "bc3") format = BlockFormat::BC3;
+    else if (formatName == "bc7") format = BlockFormat::BC7;
+    else {
+        std::cerr << "Format inconnu : " << formatName << std::endl;
+        return 1;
+    }
+    MipFilter filter = filterName == "box" ? MipFilter::Box : MipFilter::Kaiser;
+
+    // meme orientation que le chargement a l'execution (origine en bas a gauche)
+    stbi_set_flip_vertically_on_load(true);
+    int width, height, channels;
+    unsigned char* pixels = stbi_load(input.c_str(), &width, &height, &channels, 4);
+    if (!pixels) {
+        std::cerr << "Fail : " << input << std::endl;
+        return 1;
+    }
+    TextureImage base(width, height);
+    std::copy(pixels, pixels + base.rgba.size(), base.rgba.begin());
+    stbi_image_free(pixels);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<TextureImage> chain = TextureCompress::buildMipChain(base, filter);
+    auto mipped = std::chrono::high_resolution_clock::now();
+
+    std::vector<CompressedLevel> levels;
+    size_t compressedBytes = 0, rawBytes = 0;
+    for (size_t i = 0; i < chain.size(); i++) {
+        levels.push_back(TextureCompress::compress(chain[i], format));
+        compressedBytes += levels.back().data.size();
+        rawBytes += chain[i].rgba.size();
+
+        TextureImage decoded = TextureCompress::decompress(levels.back().data.data(), chain[i].width, chain[i].height, format);
+        TextureMetrics metrics = TextureCompress::measure(chain[i], decoded);
+        std::cout << "Mip " << i << " : " << chain[i].width << "x" << chain[i].height
+                  << " | PSNR RGB: " << metrics.psnrRGB << " dB, Alpha: " << metrics.psnrAlpha << " dB" << std::endl;
+    }
+    auto encoded = std::chrono::high_resolution_clock::now();
+
+    if (!TextureCompress::writeKTX(output, format, levels)) {
+        std::cerr << "Fail : " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << "Texture : " << output << " | " << formatName << ", " << levels.size() << " mips, "
+              << rawBytes / 1024 << " Ko -> " << compressedBytes / 1024 << " Ko"
+              << " | mips: " << std::chrono::duration<double, std::milli>(mipped - start).count() << " ms"
+              << ", encodage: " << std::chrono::duration<double, std::milli>(encoded - mipped).count() << " ms" << std::endl;
+    return 0;
+}